@@ -0,0 +1,77 @@
+#include <cstdio>
+
+#include <QVector>
+#include <QDateTime>
+#include <QJsonValue>
+#include <QElapsedTimer>
+
+#include "common.h"
+#include "messages.h"
+
+#define BENCH_DATES         1000
+#define BENCH_ROUNDS        200
+
+/*
+ * Compares QDateTime::fromString(DATE_FORMAT), which the decoders used to go
+ * through, with DecodeDate on the same JSON values
+ */
+
+static void Report(const char* name, qint64 nsecs, int count) {
+	std::printf("%-28s %8.1f ns/date\n", name, static_cast<double>(nsecs) / count);
+}
+
+int main() {
+	QVector<QJsonValue> values;
+
+	values.reserve(BENCH_DATES);
+
+	QDateTime start = QDateTime::currentDateTime().addDays(-BENCH_DATES);
+
+	for (int i = 0; i < BENCH_DATES; ++i) {
+		values.append(QJsonValue(start.addSecs(i * 86413).toString(DATE_FORMAT)));
+	}
+
+	int count = BENCH_DATES * BENCH_ROUNDS;
+	int mismatches = 0;
+
+	qint64 checksum = 0;
+
+	QElapsedTimer timer;
+
+	timer.start();
+
+	for (int round = 0; round < BENCH_ROUNDS; ++round) {
+		for (const QJsonValue& value : values) {
+			checksum += QDateTime::fromString(value.toString(), DATE_FORMAT).toSecsSinceEpoch();
+		}
+	}
+
+	Report("QDateTime::fromString", timer.nsecsElapsed(), count);
+
+	timer.restart();
+
+	for (int round = 0; round < BENCH_ROUNDS; ++round) {
+		for (const QJsonValue& value : values) {
+			QDateTime date;
+
+			if (DecodeDate(value, &date)) {
+				checksum -= date.toSecsSinceEpoch();
+			}
+		}
+	}
+
+	Report("DecodeDate(QJsonValue)", timer.nsecsElapsed(), count);
+
+	for (const QJsonValue& value : values) {
+		QDateTime date;
+
+		if (!DecodeDate(value, &date)
+				|| date != QDateTime::fromString(value.toString(), DATE_FORMAT)) {
+			++mismatches;
+		}
+	}
+
+	std::printf("mismatches: %d, checksum: %lld\n", mismatches, static_cast<long long>(checksum));
+
+	return (mismatches == 0) ? 0 : 1;
+}
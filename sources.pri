@@ -8,9 +8,20 @@ FORMS += src/widgets/main_widget.ui \
 
 SOURCES += src/main.cpp \
     src/crypto.cpp \
+    src/interned_string.cpp \
     src/server.cpp \
     src/client.cpp \
     src/bridge.cpp \
+    src/messages.cpp \
+    src/message_reader.cpp \
+    src/notification_mirror.cpp \
+    src/sms_cache.cpp \
+    src/message_store.cpp \
+    src/notification_history.cpp \
+    src/search_index.cpp \
+    src/toast_scheduler.cpp \
+    src/notification_throttle.cpp \
+    src/notification_change_log.cpp \
     src/openvr/rigid_transform.cpp \
     src/openvr/overlay_controller.cpp \
     src/widgets/fade_widget.cpp \
@@ -18,10 +29,15 @@ SOURCES += src/main.cpp \
     src/widgets/focus_plain_text_edit.cpp \
     src/widgets/highlight_button.cpp \
     src/widgets/vertical_scroll_area.cpp \
+    src/widgets/loading_spinner.cpp \
+    src/widgets/theme.cpp \
     src/widgets/main_widget.cpp \
     src/widgets/notification_widget.cpp \
-    src/widgets/sms_widget.cpp \
-    src/widgets/short_sms_widget.cpp \
+    src/widgets/notification_list_model.cpp \
+    src/widgets/notification_item_delegate.cpp \
+    src/widgets/sms_list_model.cpp \
+    src/widgets/sms_item_delegate.cpp \
+    src/widgets/thread_view.cpp \
     src/widgets/tabs/notifications_tab_widget.cpp \
     src/widgets/tabs/sms_tab_widget.cpp \
     src/widgets/tabs/device_tab_widget.cpp \
@@ -29,20 +45,38 @@ SOURCES += src/main.cpp \
 
 HEADERS += src/common.h \
     src/crypto.h \
+    src/interned_string.h \
     src/server.h \
     src/client.h \
     src/bridge.h \
+    src/batch.h \
+    src/messages.h \
+    src/message_reader.h \
+    src/notification_mirror.h \
+    src/sms_cache.h \
+    src/message_store.h \
+    src/notification_history.h \
+    src/search_index.h \
+    src/toast_scheduler.h \
+    src/notification_throttle.h \
+    src/notification_change_log.h \
     src/openvr/rigid_transform.h \
     src/openvr/overlay_controller.h \
     src/widgets/fade_widget.h \
+    src/widgets/lazy_tab.h \
     src/widgets/focus_line_edit.h \
     src/widgets/focus_plain_text_edit.h \
     src/widgets/highlight_button.h \
     src/widgets/vertical_scroll_area.h \
+    src/widgets/loading_spinner.h \
+    src/widgets/theme.h \
     src/widgets/main_widget.h \
     src/widgets/notification_widget.h \
-    src/widgets/sms_widget.h \
-    src/widgets/short_sms_widget.h \
+    src/widgets/notification_list_model.h \
+    src/widgets/notification_item_delegate.h \
+    src/widgets/sms_list_model.h \
+    src/widgets/sms_item_delegate.h \
+    src/widgets/thread_view.h \
     src/widgets/tabs/notifications_tab_widget.h \
     src/widgets/tabs/sms_tab_widget.h \
     src/widgets/tabs/device_tab_widget.h \
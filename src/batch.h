@@ -0,0 +1,109 @@
+#pragma once
+
+#include <utility>
+
+#include <QVector>
+
+/*
+ * Contiguous list payload handed from the bridge to the UI
+ *
+ * Items are stored in a single reserved block. Batches are move-only so a
+ * list is never copied on its way through signals, Share() returns a
+ * shallow (implicitly shared) handle for receivers that need to keep it.
+ */
+
+template<typename T>
+class Batch {
+	public:
+		typedef typename QVector<T>::const_iterator const_iterator;
+		typedef typename QVector<T>::const_reverse_iterator const_reverse_iterator;
+
+		Batch() {
+		}
+
+		Batch(Batch&& other)
+			: m_items(std::move(other.m_items)) {
+		}
+
+		Batch& operator=(Batch&& other) {
+			m_items = std::move(other.m_items);
+
+			return *this;
+		}
+
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+
+		void Reserve(int size) {
+			m_items.reserve(size);
+		}
+
+		void Append(T&& item) {
+			m_items.append(std::move(item));
+		}
+
+		void Append(const T& item) {
+			m_items.append(item);
+		}
+
+		void Prepend(const T& item) {
+			m_items.prepend(item);
+		}
+
+		/* Appends a default item to be filled in place */
+		T& Emplace() {
+			m_items.append(T());
+
+			return m_items.last();
+		}
+
+		void RemoveLast() {
+			m_items.removeLast();
+		}
+
+		void Clear() {
+			m_items.clear();
+		}
+
+		Batch Share() const {
+			Batch batch;
+			batch.m_items = m_items;
+
+			return batch;
+		}
+
+		const QVector<T>& Items() const {
+			return m_items;
+		}
+
+		int Size() const {
+			return m_items.size();
+		}
+
+		bool IsEmpty() const {
+			return m_items.isEmpty();
+		}
+
+		const T& At(int index) const {
+			return m_items.at(index);
+		}
+
+		const_iterator begin() const {
+			return m_items.cbegin();
+		}
+
+		const_iterator end() const {
+			return m_items.cend();
+		}
+
+		const_reverse_iterator rbegin() const {
+			return m_items.crbegin();
+		}
+
+		const_reverse_iterator rend() const {
+			return m_items.crend();
+		}
+
+	private:
+		QVector<T> m_items;
+};
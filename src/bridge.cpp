@@ -1,5 +1,3 @@
-#include <QJsonArray>
-
 #include <spdlog/spdlog.h>
 
 #include "bridge.h"
@@ -8,14 +6,37 @@ Bridge::Bridge(QObject* parent)
 	: QObject(parent) {
 }
 
+bool Bridge::GetNotifications(Batch<Notification>* list) const {
+	if (!m_notificationMirror.IsComplete()) {
+		return false;
+	}
+
+	*list = m_notificationMirror.Snapshot();
+
+	return true;
+}
+
+void Bridge::RestoreNotifications(const Batch<Notification>& list) {
+	/* Not numbered, the phone has to send a full list first */
+	m_notificationMirror.Assign(list, 0);
+}
+
 void Bridge::ListNotifications() {
 	QJsonObject object;
 
 	object.insert("type", "list_notifications");
 
+	if (m_notificationMirror.IsSynced()) {
+		object.insert("since", m_notificationMirror.Sequence());
+	}
+
 	emit EmitMessage(object);
 }
 
+void Bridge::ResetNotifications() {
+	m_notificationMirror.Reset();
+}
+
 void Bridge::DismissNotification(const QString& key) {
 	if (!key.isEmpty()) {
 		QJsonObject object;
@@ -27,6 +48,13 @@ void Bridge::DismissNotification(const QString& key) {
 	}
 }
 
+void Bridge::DismissNotifications(const QStringList& keys) {
+	/* The phone only knows about single keys */
+	for (const QString& key : keys) {
+		DismissNotification(key);
+	}
+}
+
 void Bridge::ListSMS() {
 	QJsonObject object;
 
@@ -63,166 +91,109 @@ void Bridge::SendSMS(const QString& destination, const QString& body) {
 }
 
 void Bridge::ParseMessage(const QString& type, const QJsonObject& json) {
-	if (type == "notification_received") {
-		QJsonObject jsonNotification = json.value("notification").toObject();
-
-		if (jsonNotification.contains("key")
-				&& jsonNotification.contains("app_name")
-				&& jsonNotification.contains("title")) {
-			Notification notification = {
-				jsonNotification.value("persistent").toBool(false), /* persistent */
-				jsonNotification.value("key").toString(), /* key */
-				jsonNotification.value("app_name").toString(), /* appName */
-				jsonNotification.value("title").toString(), /* title */
-				jsonNotification.value("text").toString() /* text */
-			};
-
-			if (!notification.key.isEmpty()
-					&& !notification.appName.isEmpty()
-					&& !notification.title.isEmpty()) {
-				emit NotificationReceived(notification);
-			}
-		}
-	} else if (type == "notification_removed") {
-		QJsonObject jsonNotification = json.value("notification").toObject();
-
-		if (jsonNotification.contains("key")
-				&& jsonNotification.contains("app_name")
-				&& jsonNotification.contains("title")) {
-			Notification notification = {
-				jsonNotification.value("persistent").toBool(false), /* persistent */
-				jsonNotification.value("key").toString(), /* key */
-				jsonNotification.value("app_name").toString(), /* appName */
-				jsonNotification.value("title").toString(), /* title */
-				jsonNotification.value("text").toString() /* text */
-			};
-
-			if (!notification.key.isEmpty()
-					&& !notification.appName.isEmpty()
-					&& !notification.title.isEmpty()) {
-				emit NotificationRemoved(notification);
-			}
-		}
-	} else if (type == "notification_list") {
-		QJsonArray jsonList = json.value("list").toArray();
-
-		std::list<Notification> list;
-
-		auto iterator = jsonList.begin();
-
-		while (iterator != jsonList.end()) {
-			QJsonObject jsonNotification = iterator->toObject();
-
-			if (jsonNotification.contains("key")
-					&& jsonNotification.contains("app_name")
-					&& jsonNotification.contains("title")) {
-				Notification notification = {
-					jsonNotification.value("persistent").toBool(false), /* persistent */
-					jsonNotification.value("key").toString(), /* key */
-					jsonNotification.value("app_name").toString(), /* appName */
-					jsonNotification.value("title").toString(), /* title */
-					jsonNotification.value("text").toString() /* text */
-				};
-
-				if (!notification.key.isEmpty()
-						&& !notification.appName.isEmpty()
-						&& !notification.title.isEmpty()) {
-					list.push_back(notification);
-				}
-			}
-
-			++iterator;
-		}
+	switch (MessageTypeHash(type)) {
+#define DISPATCH_MESSAGE(name, message, handler) \
+		case MessageTypeHash(name): \
+			if (type == QLatin1String(name)) { \
+				Dispatch<message>(json, &Bridge::handler); \
+				return; \
+			} \
+			break;
 
-		emit NotificationList(list);
-	} else if (type == "sms_list") {
-		QJsonArray jsonList = json.value("list").toArray();
+			BRIDGE_MESSAGES(DISPATCH_MESSAGE)
 
-		std::list<SMS> list;
+#undef DISPATCH_MESSAGE
 
-		auto iterator = jsonList.begin();
+		default:
+			break;
+	}
 
-		while (iterator != jsonList.end()) {
-			QJsonObject jsonSms = iterator->toObject();
+	spdlog::warn(std::string("Unkown message type: ") + type.toStdString());
+}
 
-			if (jsonSms.contains("type")
-					&& jsonSms.contains("date")
-					&& jsonSms.contains("body")
-					&& jsonSms.contains("number")) {
-				SMS sms = {
-					(jsonSms.value("type").toString() == "in"), /* incoming */
-					QDateTime::fromString(jsonSms.value("date").toString(),
-										  DATE_FORMAT), /* date */
-					jsonSms.value("body").toString(), /* body */
-					jsonSms.value("number").toString(), /* number */
-					jsonSms.value("name").toString() /* name */
-				};
+void Bridge::ParseStreamedMessage(const StreamedMessage& message) {
+	switch (message.type) {
+		case StreamedType::NOTIFICATION_RECEIVED:
+			OnNotificationReceived(message.notification);
+			break;
 
-				if (sms.date.isValid() && !sms.number.isEmpty()) {
-					list.push_back(sms);
-				}
-			}
+		case StreamedType::NOTIFICATION_REMOVED:
+			OnNotificationRemoved(message.notification);
+			break;
 
-			++iterator;
-		}
+		case StreamedType::NOTIFICATION_LIST:
+			OnNotificationList(message.notificationList);
+			break;
 
-		emit SMSList(list);
-	} else if (type == "sms_from_list") {
-		QString number = json.value("number").toString();
-		int page = json.value("page").toInt();
+		case StreamedType::SMS_LIST:
+			OnSMSList(message.smsList);
+			break;
 
-		if (!number.isEmpty()) {
-			QString name = json.value("name").toString();
+		case StreamedType::SMS_FROM_LIST:
+			OnSMSFromList(message.smsFromList);
+			break;
 
-			QJsonArray jsonList = json.value("list").toArray();
+		default:
+			break;
+	}
+}
 
-			std::list<ShortSMS> list;
+template<typename Message>
+void Bridge::Dispatch(const QJsonObject& json, void (Bridge::*handler)(const Message&)) {
+	Message message;
 
-			auto iterator = jsonList.begin();
+	if (Message::Decode(json, &message)) {
+		(this->*handler)(message);
+	}
+}
 
-			while (iterator != jsonList.end()) {
-				QJsonObject jsonSms = iterator->toObject();
+void Bridge::OnNotificationReceived(const NotificationMessage& message) {
+	m_notificationMirror.Insert(message.notification, message.sequence);
 
-				if (jsonSms.contains("type")
-						&& jsonSms.contains("date")
-						&& jsonSms.contains("body")) {
-					ShortSMS shortSms = {
-						(jsonSms.value("type").toString() == "in"), /* incoming */
-						QDateTime::fromString(jsonSms.value("date").toString(),
-											  DATE_FORMAT), /* date */
-						jsonSms.value("body").toString() /* body */
-					};
+	emit NotificationReceived(message.notification);
+}
 
-					if (shortSms.date.isValid()) {
-						list.push_back(shortSms);
-					}
-				}
+void Bridge::OnNotificationRemoved(const NotificationMessage& message) {
+	m_notificationMirror.Remove(message.notification.key, message.sequence);
 
-				++iterator;
-			}
+	emit NotificationRemoved(message.notification);
+}
 
-			emit SMSFromList(number, name, page, list);
-		}
-	} else if (type == "sms_sent") {
-		QString number = json.value("number").toString();
-		bool success = json.value("success").toBool();
-
-		QJsonObject jsonSms = json.value("sms").toObject();
-
-		if (!number.isEmpty()
-				&& jsonSms.contains("type")
-				&& jsonSms.contains("date")
-				&& jsonSms.contains("body")) {
-			ShortSMS shortSms = {
-				(jsonSms.value("type").toString() == "in"), /* incoming */
-				QDateTime::fromString(jsonSms.value("date").toString(),
-									  DATE_FORMAT), /* date */
-				jsonSms.value("body").toString() /* body */
-			};
-
-			emit SMSSent(number, success, shortSms);
-		}
-	} else {
-		spdlog::warn(std::string("Unkown message type: ") + type.toStdString());
+void Bridge::OnNotificationList(const NotificationListMessage& message) {
+	if (!message.delta) {
+		m_notificationMirror.Assign(message.list, message.sequence);
+
+		emit NotificationList(message.list);
+		return;
 	}
+
+	if (!m_notificationMirror.ApplyDelta(message.list,
+										 message.removed,
+										 message.since,
+										 message.sequence)) {
+		spdlog::warn("Notification delta does not match local list, requesting full list");
+
+		m_notificationMirror.Reset();
+
+		ListNotifications();
+		return;
+	}
+
+	emit NotificationList(m_notificationMirror.Snapshot());
+}
+
+void Bridge::OnSMSList(const SMSListMessage& message) {
+	emit SMSList(message.list);
+}
+
+void Bridge::OnSMSFromList(const SMSFromListMessage& message) {
+	emit SMSFromList(message.number, message.name, message.page, message.list);
+}
+
+void Bridge::OnSMSSent(const SMSSentMessage& message) {
+	emit SMSSent(message.number, message.success, message.sms);
+}
+
+void Bridge::OnSMSReceived(const SMSReceivedMessage& message) {
+	emit SMSReceived(message.sms);
 }
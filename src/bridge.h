@@ -1,9 +1,12 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
 #include <QJsonObject>
 
 #include "common.h"
+#include "messages.h"
+#include "notification_mirror.h"
 
 class Bridge : public QObject {
 		Q_OBJECT
@@ -11,11 +14,17 @@ class Bridge : public QObject {
 	public:
 		Bridge(QObject* parent = nullptr);
 
+		bool GetNotifications(Batch<Notification>* list) const;
+		void RestoreNotifications(const Batch<Notification>& list);
+
 	public slots:
 		void ParseMessage(const QString& type, const QJsonObject& json);
+		void ParseStreamedMessage(const StreamedMessage& message);
 
 		void ListNotifications();
+		void ResetNotifications();
 		void DismissNotification(const QString& key);
+		void DismissNotifications(const QStringList& keys);
 		void ListSMS();
 		void ListSMSFrom(const QString& number, int page = 0);
 		void SendSMS(const QString& destination, const QString& body);
@@ -25,11 +34,26 @@ class Bridge : public QObject {
 
 		void NotificationReceived(const Notification& notification);
 		void NotificationRemoved(const Notification& notification);
-		void NotificationList(const std::list<Notification>& list);
-		void SMSList(const std::list<SMS>& list);
+		void NotificationList(const Batch<Notification>& list);
+		void SMSList(const Batch<SMS>& list);
 		void SMSFromList(const QString& number,
 						 const QString& name,
 						 int page,
-						 const std::list<ShortSMS>& list);
+						 const Batch<ShortSMS>& list);
 		void SMSSent(const QString& number, bool success, const ShortSMS& shortSms);
+		void SMSReceived(const SMS& sms);
+
+	private:
+		NotificationMirror m_notificationMirror;
+
+		template<typename Message>
+		void Dispatch(const QJsonObject& json, void (Bridge::*handler)(const Message&));
+
+		void OnNotificationReceived(const NotificationMessage& message);
+		void OnNotificationRemoved(const NotificationMessage& message);
+		void OnNotificationList(const NotificationListMessage& message);
+		void OnSMSList(const SMSListMessage& message);
+		void OnSMSFromList(const SMSFromListMessage& message);
+		void OnSMSSent(const SMSSentMessage& message);
+		void OnSMSReceived(const SMSReceivedMessage& message);
 };
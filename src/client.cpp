@@ -7,6 +7,7 @@
 #include <spdlog/spdlog.h>
 
 #include "client.h"
+#include "message_reader.h"
 
 Client::Client(const QString* serverPublicKey,
 			   const QString* serverSecretKey,
@@ -230,10 +231,10 @@ void Client::ProcessMessage(const QString& message) {
 		return;
 	}
 
-	QJsonDocument document;
+	QByteArray data;
 
 	try {
-		document = QJsonDocument::fromJson(m_crypto->Decrypt(message).toUtf8());
+		data = m_crypto->Decrypt(message).toUtf8();
 	} catch (const std::runtime_error& ex) {
 		spdlog::warn(std::string("ProcessMessage: ") + ex.what());
 
@@ -241,6 +242,17 @@ void Client::ProcessMessage(const QString& message) {
 		return;
 	}
 
+	if (m_handshakeDone) {
+		StreamedMessage streamedMessage;
+
+		if (MessageReader::Read(data, &streamedMessage)) {
+			emit StreamedMessageReceived(streamedMessage);
+			return;
+		}
+	}
+
+	QJsonDocument document = QJsonDocument::fromJson(data);
+
 	if (document.isNull() || !document.isObject()) {
 		spdlog::warn("ProcessMessage: Invalid message");
 
@@ -5,6 +5,7 @@
 #include <QTcpSocket>
 
 #include "crypto.h"
+#include "messages.h"
 
 class Client : public QObject {
 		Q_OBJECT
@@ -45,6 +46,7 @@ class Client : public QObject {
 	signals:
 		void HandshakePending();
 		void MessageReceived(const QString& type, const QJsonObject& json);
+		void StreamedMessageReceived(const StreamedMessage& message);
 		void Disconnected();
 
 	private:
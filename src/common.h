@@ -7,6 +7,8 @@
 #include <QString>
 #include <QDateTime>
 
+#include "interned_string.h"
+
 #define APP_ORG                     "desuuuu"
 #define APP_NAME                    "OVRPhoneBridge"
 
@@ -15,6 +17,7 @@
 
 #define OVERLAY_NAME                "Phone Bridge"
 #define OVERLAY_THUMB_PATH          "overlay_icon.png"
+#define OVERLAY_RENDER_INTERVAL     15
 
 #define LOG_MAX_SIZE                (5 * 1024 * 1024)
 #define LOG_MAX_FILES               3
@@ -25,21 +28,49 @@
 #define DEFAULT_AUTOSTART           true
 #define KICK_BANTIME                300U
 #define HANDSHAKE_WINDOW            150U
+#define RECONNECT_GRACE_PERIOD      30000
+
+#define STORE_PATH                  "store.bin"
+#define STORE_SAVE_DELAY            10000
+#define STORE_MAX_THREADS           10
+
+#define HISTORY_PATH                "history.bin"
+#define HISTORY_SLOTS               2048
+#define HISTORY_SLOT_SIZE           1024
+#define HISTORY_PAGE_SIZE           20
+
+#define SEARCH_MAX_DOCUMENTS        5000
+#define SEARCH_MAX_TEXT_LENGTH      500
+#define SEARCH_MAX_TOKEN_LENGTH     32
+#define SEARCH_MAX_RESULTS          30
+
+#define SYSTEM_NOTIFICATION_PREFIX  "bridge:"
+#define TOAST_COALESCE_WINDOW       2000
+#define TOAST_SOUND_INTERVAL        5000
+#define NOTIF_UPDATE_INTERVAL       1000
 
 #define NOTIF_TITLE_MAX_LENGTH      40
 #define NOTIF_TEXT_MAX_LENGTH       250
+#define NOTIF_GROUP_MIN_SIZE        3
 #define SMS_PREVIEW_MAX_LENGTH      45
-#define SMS_MAX_PAGE                8
+#define SMS_MAX_LOADED_PAGES        6
+#define SMS_PREFETCH_BUBBLES        5
 #define SMS_MAX_LENGTH              150
+#define SMS_CACHE_BUDGET            (2 * 1024 * 1024)
+#define SMS_PREFETCH_THREADS        5
+#define SMS_PREFETCH_DELAY          1500
+#define SMS_SEND_TIMEOUT            60000
 
 #define TIMESTAMP_LEEWAY            300U
 
 #define SCROLL_SPEED                30.0f
+#define SPINNER_SIZE                70
 
 #define DATE_FORMAT                 "yyyy-MM-dd'T'HH:mm:ss'Z'"
 
 #define KEYBOARD_INPUT_PORT         0
 #define KEYBOARD_INPUT_SMS          1
+#define KEYBOARD_INPUT_SEARCH       2
 
 //Prevents placement issues with fully opaque QGraphicsOpacityEffect
 #define OPACITY_EFFECT_MAX          0.9999
@@ -69,14 +100,14 @@ struct SMS {
 	bool incoming;
 	QDateTime date;
 	QString body;
-	QString number;
-	QString name;
+	InternedString number;
+	InternedString name;
 };
 
 struct Notification {
 	bool persistent;
 	QString key;
-	QString appName;
+	InternedString appName;
 	QString title;
 	QString text;
 };
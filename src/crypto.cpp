@@ -5,6 +5,7 @@
 #include <sodium/utils.h>
 #include <sodium/randombytes.h>
 #include <sodium/crypto_box.h>
+#include <sodium/crypto_kdf.h>
 #include <sodium/crypto_shorthash.h>
 #include <sodium/crypto_aead_xchacha20poly1305.h>
 
@@ -290,6 +291,44 @@ void Crypto::GenerateKeyPair(QSettings* settings) {
 	spdlog::info(std::string("Key pair generated with identifier: ") + identifier.toStdString());
 }
 
+void Crypto::DeriveStorageKey(const QString& secretKeyHex,
+							  uint64_t subkeyId,
+							  unsigned char* key,
+							  size_t keyLen) {
+	static_assert(crypto_kx_SECRETKEYBYTES == crypto_kdf_KEYBYTES, "Unexpected secret key size");
+
+	unsigned char secretKey[crypto_kx_SECRETKEYBYTES];
+
+	size_t secretKeyLen;
+
+	if (sodium_hex2bin(
+					secretKey,
+					sizeof(secretKey),
+					secretKeyHex.toUtf8().constData(),
+					static_cast<std::size_t>(secretKeyHex.length()),
+					nullptr,
+					&secretKeyLen,
+					nullptr) != 0) {
+		sodium_memzero(secretKey, sizeof(secretKey));
+
+		throw std::runtime_error("Invalid secret key");
+	}
+
+	if (secretKeyLen != crypto_kx_SECRETKEYBYTES) {
+		sodium_memzero(secretKey, sizeof(secretKey));
+
+		throw std::runtime_error("Invalid secret key length");
+	}
+
+	if (crypto_kdf_derive_from_key(key, keyLen, subkeyId, "OPBStore", secretKey) != 0) {
+		sodium_memzero(secretKey, sizeof(secretKey));
+
+		throw std::runtime_error("Failed to derive storage key");
+	}
+
+	sodium_memzero(secretKey, sizeof(secretKey));
+}
+
 QString Crypto::GetIdentifier(const unsigned char* publicKey) {
 	unsigned char key[16] = {
 		0x32, 0x65, 0x40, 0x4d, 0x1d, 0x30, 0x66, 0x34,
@@ -21,6 +21,10 @@ class Crypto {
 		QString GetClientIdentifier() const;
 
 		static void GenerateKeyPair(QSettings* settings);
+		static void DeriveStorageKey(const QString& secretKeyHex,
+									 uint64_t subkeyId,
+									 unsigned char* key,
+									 size_t keyLen);
 
 	private:
 		unsigned char m_publicKey[crypto_kx_PUBLICKEYBYTES];
@@ -0,0 +1,98 @@
+#include "interned_string.h"
+
+InternedString::InternedString()
+	: m_entry(nullptr) {
+}
+
+InternedString::InternedString(const QString& string)
+	: m_entry(nullptr) {
+	if (string.isEmpty()) {
+		return;
+	}
+
+	QHash<QString, Entry*>& pool = Pool();
+
+	auto iterator = pool.find(string);
+
+	if (iterator != pool.end()) {
+		m_entry = iterator.value();
+	} else {
+		m_entry = new Entry{string, 0};
+
+		pool.insert(m_entry->string, m_entry);
+	}
+
+	++m_entry->references;
+}
+
+InternedString::InternedString(const InternedString& other)
+	: m_entry(other.m_entry) {
+	if (m_entry != nullptr) {
+		++m_entry->references;
+	}
+}
+
+InternedString::InternedString(InternedString&& other)
+	: m_entry(other.m_entry) {
+	other.m_entry = nullptr;
+}
+
+InternedString::~InternedString() {
+	Release();
+}
+
+InternedString& InternedString::operator=(const InternedString& other) {
+	Entry* entry = other.m_entry;
+
+	if (entry != nullptr) {
+		++entry->references;
+	}
+
+	Release();
+
+	m_entry = entry;
+
+	return *this;
+}
+
+InternedString& InternedString::operator=(InternedString&& other) {
+	if (this != &other) {
+		Release();
+
+		m_entry = other.m_entry;
+		other.m_entry = nullptr;
+	}
+
+	return *this;
+}
+
+const QString& InternedString::String() const {
+	static const QString empty;
+
+	return (m_entry != nullptr) ? m_entry->string : empty;
+}
+
+bool InternedString::IsNull() const {
+	return (m_entry == nullptr);
+}
+
+void InternedString::Release() {
+	if (m_entry == nullptr) {
+		return;
+	}
+
+	if (--m_entry->references == 0) {
+		Pool().remove(m_entry->string);
+
+		delete m_entry;
+	}
+
+	m_entry = nullptr;
+}
+
+QHash<QString, InternedString::Entry*>& InternedString::Pool() {
+	/* Never freed so handles held by static objects stay valid on exit */
+	static QHash<QString, Entry*>* pool = new QHash<QString, Entry*>();
+
+	return *pool;
+}
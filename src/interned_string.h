@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+
+/*
+ * Handle to a string stored once in a shared, reference counted pool
+ *
+ * Handles to equal strings point to the same entry, so comparing and
+ * hashing them only looks at the pointer. Entries are released once the
+ * last handle goes away. Not thread-safe, only use from the main thread.
+ */
+
+class InternedString {
+	public:
+		InternedString();
+		explicit InternedString(const QString& string);
+
+		InternedString(const InternedString& other);
+		InternedString(InternedString&& other);
+		~InternedString();
+
+		InternedString& operator=(const InternedString& other);
+		InternedString& operator=(InternedString&& other);
+
+		const QString& String() const;
+		bool IsNull() const;
+
+		bool operator==(const InternedString& other) const {
+			return (m_entry == other.m_entry);
+		}
+
+		bool operator!=(const InternedString& other) const {
+			return (m_entry != other.m_entry);
+		}
+
+		bool operator<(const InternedString& other) const {
+			return (m_entry < other.m_entry);
+		}
+
+		friend uint qHash(const InternedString& string, uint seed);
+
+	private:
+		struct Entry {
+			QString string;
+			int references;
+		};
+
+		Entry* m_entry;
+
+		void Release();
+
+		static QHash<QString, Entry*>& Pool();
+};
+
+inline uint qHash(const InternedString& string, uint seed = 0) {
+	return qHash(reinterpret_cast<quintptr>(string.m_entry), seed);
+}
@@ -14,6 +14,7 @@
 #include "crypto.h"
 #include "openvr/overlay_controller.h"
 #include "widgets/main_widget.h"
+#include "widgets/loading_spinner.h"
 
 using namespace vr;
 using namespace OpenVR;
@@ -213,6 +214,9 @@ int main(int argc, char* argv[]) {
 
 	setupApplication();
 
+	/* Rendered before any widget and released before the application */
+	SpinnerSheet spinnerSheet(SPINNER_SIZE);
+
 	QScopedPointer<MainWidget> widget(nullptr);
 	QScopedPointer<OverlayController> controller(nullptr);
 
@@ -331,6 +335,21 @@ int main(int argc, char* argv[]) {
 						 widget.data(),
 						 &MainWidget::VROverlayShown);
 
+		QObject::connect(controller.data(),
+						 &OverlayController::OverlayHidden,
+						 widget.data(),
+						 &MainWidget::VROverlayHidden);
+
+		/* The overlay starts hidden */
+		widget->VROverlayHidden();
+
+		QObject::connect(controller.data(),
+						 &OverlayController::RenderTick,
+						 &spinnerSheet,
+						 &SpinnerSheet::Tick);
+
+		spinnerSheet.UseTimer(false);
+
 		QObject::connect(controller.data(),
 						 &OverlayController::NotificationOpened,
 						 widget.data(),
@@ -0,0 +1,1029 @@
+#include <limits>
+#include <cstring>
+
+#include "message_reader.h"
+
+#define FIELD_KEY       (1 << 0)
+#define FIELD_APP_NAME  (1 << 1)
+#define FIELD_TITLE     (1 << 2)
+#define FIELD_TYPE      (1 << 3)
+#define FIELD_DATE      (1 << 4)
+#define FIELD_BODY      (1 << 5)
+#define FIELD_NUMBER    (1 << 6)
+
+static bool KeyEquals(const char* key, int length, const char* literal) {
+	return (static_cast<size_t>(length) == strlen(literal)
+			&& memcmp(key, literal, static_cast<size_t>(length)) == 0);
+}
+
+static void AppendUTF8(QByteArray* buffer, uint32_t code) {
+	if (code < 0x80) {
+		buffer->append(static_cast<char>(code));
+	} else if (code < 0x800) {
+		buffer->append(static_cast<char>(0xc0 | (code >> 6)));
+		buffer->append(static_cast<char>(0x80 | (code & 0x3f)));
+	} else if (code < 0x10000) {
+		buffer->append(static_cast<char>(0xe0 | (code >> 12)));
+		buffer->append(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+		buffer->append(static_cast<char>(0x80 | (code & 0x3f)));
+	} else {
+		buffer->append(static_cast<char>(0xf0 | (code >> 18)));
+		buffer->append(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+		buffer->append(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+		buffer->append(static_cast<char>(0x80 | (code & 0x3f)));
+	}
+}
+
+MessageReader::MessageReader(const char* begin, const char* end)
+	: m_position(begin),
+	  m_end(end),
+	  m_depth(0) {
+}
+
+bool MessageReader::Read(const QByteArray& data, StreamedMessage* message) {
+	MessageReader reader(data.constData(), data.constData() + data.size());
+
+	return reader.ReadMessage(message);
+}
+
+bool MessageReader::ReadMessage(StreamedMessage* message) {
+	message->type = StreamedType::NONE;
+
+	bool hasNotification = false;
+
+	QString number;
+	QString name;
+	int page = 0;
+
+	qint64 sequence = 0;
+	qint64 since = 0;
+	bool delta = false;
+
+	SkipWhitespace();
+
+	if (!Consume('{')) {
+		return false;
+	}
+
+	SkipWhitespace();
+
+	if (!Consume('}')) {
+		do {
+			const char* key;
+			int length;
+
+			SkipWhitespace();
+
+			if (!ReadKey(&key, &length)) {
+				return false;
+			}
+
+			SkipWhitespace();
+
+			if (!Consume(':')) {
+				return false;
+			}
+
+			SkipWhitespace();
+
+			if (KeyEquals(key, length, "type")) {
+				const char* type;
+				int typeLength;
+
+				if (!ReadKey(&type, &typeLength)) {
+					return false;
+				}
+
+				StreamedType streamedType = GetType(type, typeLength);
+
+				/* A list already read may have been decoded for another type */
+				if (streamedType == StreamedType::NONE
+						|| (message->type != StreamedType::NONE && message->type != streamedType)) {
+					return false;
+				}
+
+				message->type = streamedType;
+			} else if (KeyEquals(key, length, "notification")) {
+				hasNotification = false;
+
+				if (Peek('{')) {
+					if (!ReadNotification(&message->notification.notification, &hasNotification)) {
+						return false;
+					}
+				} else if (!SkipValue()) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "list")) {
+				bool success;
+
+				/* Items are decoded into the batch of the message type */
+				switch (message->type) {
+					case StreamedType::NOTIFICATION_LIST:
+						message->notificationList.list.Clear();
+
+						success = !Peek('[')
+								  ? SkipValue()
+								  : ReadList(&message->notificationList.list, &MessageReader::ReadNotification);
+						break;
+
+					case StreamedType::SMS_LIST:
+						message->smsList.list.Clear();
+
+						success = !Peek('[')
+								  ? SkipValue()
+								  : ReadList(&message->smsList.list, &MessageReader::ReadSMS);
+						break;
+
+					case StreamedType::SMS_FROM_LIST:
+						message->smsFromList.list.Clear();
+
+						success = !Peek('[')
+								  ? SkipValue()
+								  : ReadList(&message->smsFromList.list, &MessageReader::ReadShortSMS);
+						break;
+
+					case StreamedType::NONE:
+						success = false;
+						break;
+
+					default:
+						success = SkipValue();
+						break;
+				}
+
+				if (!success) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "number")) {
+				if (!ReadStringField(&number)) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "name")) {
+				if (!ReadStringField(&name)) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "page")) {
+				if (!ReadIntField(&page)) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "seq")) {
+				if (!ReadInt64Field(&sequence)) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "since")) {
+				if (!ReadInt64Field(&since)) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "delta")) {
+				if (!ReadBoolField(&delta)) {
+					return false;
+				}
+			} else if (KeyEquals(key, length, "removed")) {
+				message->notificationList.removed.Clear();
+
+				if (Peek('[')) {
+					if (!ReadStringList(&message->notificationList.removed)) {
+						return false;
+					}
+				} else if (!SkipValue()) {
+					return false;
+				}
+			} else if (!SkipValue()) {
+				return false;
+			}
+
+			SkipWhitespace();
+		} while (Consume(','));
+
+		if (!Consume('}')) {
+			return false;
+		}
+	}
+
+	SkipWhitespace();
+
+	if (m_position != m_end) {
+		return false;
+	}
+
+	switch (message->type) {
+		case StreamedType::NOTIFICATION_RECEIVED:
+		case StreamedType::NOTIFICATION_REMOVED:
+			message->notification.sequence = (sequence > 0) ? sequence : 0;
+
+			return hasNotification;
+
+		case StreamedType::NOTIFICATION_LIST:
+			message->notificationList.sequence = (sequence > 0) ? sequence : 0;
+			message->notificationList.since = (since > 0) ? since : 0;
+			message->notificationList.delta = delta;
+
+			return true;
+
+		case StreamedType::SMS_LIST:
+			return true;
+
+		case StreamedType::SMS_FROM_LIST:
+			if (number.isEmpty()) {
+				return false;
+			}
+
+			message->smsFromList.number = number;
+			message->smsFromList.name = name;
+			message->smsFromList.page = page;
+
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+bool MessageReader::ReadNotification(Notification* notification, bool* valid) {
+	uint16_t fields = 0;
+
+	QString appName;
+
+	notification->persistent = false;
+	notification->key.clear();
+	notification->title.clear();
+	notification->text.clear();
+
+	bool success = ReadObject([&](const char* key, int length) {
+		if (KeyEquals(key, length, "key")) {
+			fields |= FIELD_KEY;
+
+			return ReadStringField(&notification->key);
+		}
+
+		if (KeyEquals(key, length, "app_name")) {
+			fields |= FIELD_APP_NAME;
+
+			return ReadStringField(&appName);
+		}
+
+		if (KeyEquals(key, length, "title")) {
+			fields |= FIELD_TITLE;
+
+			return ReadStringField(&notification->title);
+		}
+
+		if (KeyEquals(key, length, "text")) {
+			return ReadStringField(&notification->text);
+		}
+
+		if (KeyEquals(key, length, "persistent")) {
+			return ReadBoolField(&notification->persistent);
+		}
+
+		return SkipValue();
+	});
+
+	if (!success) {
+		return false;
+	}
+
+	notification->appName = InternedString(appName);
+
+	*valid = ((fields & (FIELD_KEY | FIELD_APP_NAME | FIELD_TITLE)) == (FIELD_KEY | FIELD_APP_NAME | FIELD_TITLE)
+			  && !notification->key.isEmpty()
+			  && !notification->appName.IsNull()
+			  && !notification->title.isEmpty());
+
+	return true;
+}
+
+bool MessageReader::ReadSMS(SMS* sms, bool* valid) {
+	uint16_t fields = 0;
+
+	QString number;
+	QString name;
+
+	sms->incoming = false;
+	sms->date = QDateTime();
+	sms->body.clear();
+
+	bool success = ReadObject([&](const char* key, int length) {
+		if (KeyEquals(key, length, "type")) {
+			fields |= FIELD_TYPE;
+
+			return ReadTypeField(&sms->incoming);
+		}
+
+		if (KeyEquals(key, length, "date")) {
+			fields |= FIELD_DATE;
+
+			return ReadDateField(&sms->date);
+		}
+
+		if (KeyEquals(key, length, "body")) {
+			fields |= FIELD_BODY;
+
+			return ReadStringField(&sms->body);
+		}
+
+		if (KeyEquals(key, length, "number")) {
+			fields |= FIELD_NUMBER;
+
+			return ReadStringField(&number);
+		}
+
+		if (KeyEquals(key, length, "name")) {
+			return ReadStringField(&name);
+		}
+
+		return SkipValue();
+	});
+
+	if (!success) {
+		return false;
+	}
+
+	sms->number = InternedString(number);
+	sms->name = InternedString(name);
+
+	*valid = ((fields & (FIELD_TYPE | FIELD_DATE | FIELD_BODY | FIELD_NUMBER))
+			  == (FIELD_TYPE | FIELD_DATE | FIELD_BODY | FIELD_NUMBER)
+			  && sms->date.isValid()
+			  && !sms->number.IsNull());
+
+	return true;
+}
+
+bool MessageReader::ReadShortSMS(ShortSMS* shortSms, bool* valid) {
+	uint16_t fields = 0;
+
+	shortSms->incoming = false;
+	shortSms->date = QDateTime();
+	shortSms->body.clear();
+
+	bool success = ReadObject([&](const char* key, int length) {
+		if (KeyEquals(key, length, "type")) {
+			fields |= FIELD_TYPE;
+
+			return ReadTypeField(&shortSms->incoming);
+		}
+
+		if (KeyEquals(key, length, "date")) {
+			fields |= FIELD_DATE;
+
+			return ReadDateField(&shortSms->date);
+		}
+
+		if (KeyEquals(key, length, "body")) {
+			fields |= FIELD_BODY;
+
+			return ReadStringField(&shortSms->body);
+		}
+
+		return SkipValue();
+	});
+
+	if (!success) {
+		return false;
+	}
+
+	*valid = ((fields & (FIELD_TYPE | FIELD_DATE | FIELD_BODY)) == (FIELD_TYPE | FIELD_DATE | FIELD_BODY)
+			  && shortSms->date.isValid());
+
+	return true;
+}
+
+template<typename T>
+bool MessageReader::ReadList(Batch<T>* list, bool (MessageReader::*readItem)(T*, bool*)) {
+	if (!Consume('[')) {
+		return false;
+	}
+
+	SkipWhitespace();
+
+	if (Consume(']')) {
+		return true;
+	}
+
+	do {
+		SkipWhitespace();
+
+		if (Peek('{')) {
+			bool valid;
+
+			if (!(this->*readItem)(&list->Emplace(), &valid)) {
+				return false;
+			}
+
+			if (!valid) {
+				list->RemoveLast();
+			}
+		} else if (!SkipValue()) {
+			return false;
+		}
+
+		SkipWhitespace();
+	} while (Consume(','));
+
+	return Consume(']');
+}
+
+template<typename Handler>
+bool MessageReader::ReadObject(Handler handler) {
+	if (!Consume('{')) {
+		return false;
+	}
+
+	SkipWhitespace();
+
+	if (Consume('}')) {
+		return true;
+	}
+
+	do {
+		const char* key;
+		int length;
+
+		SkipWhitespace();
+
+		if (!ReadKey(&key, &length)) {
+			return false;
+		}
+
+		SkipWhitespace();
+
+		if (!Consume(':')) {
+			return false;
+		}
+
+		SkipWhitespace();
+
+		if (!handler(key, length)) {
+			return false;
+		}
+
+		SkipWhitespace();
+	} while (Consume(','));
+
+	return Consume('}');
+}
+
+bool MessageReader::ReadStringList(Batch<QString>* list) {
+	if (!Consume('[')) {
+		return false;
+	}
+
+	SkipWhitespace();
+
+	if (Consume(']')) {
+		return true;
+	}
+
+	do {
+		SkipWhitespace();
+
+		if (Peek('"')) {
+			QString value;
+
+			if (!ReadString(&value)) {
+				return false;
+			}
+
+			list->Append(std::move(value));
+		} else if (!SkipValue()) {
+			return false;
+		}
+
+		SkipWhitespace();
+	} while (Consume(','));
+
+	return Consume(']');
+}
+
+bool MessageReader::ReadKey(const char** key, int* length) {
+	if (!Consume('"')) {
+		return false;
+	}
+
+	const char* start = m_position;
+
+	while (m_position < m_end && *m_position != '"') {
+		if (*m_position == '\\' || static_cast<unsigned char>(*m_position) < 0x20) {
+			return false;
+		}
+
+		++m_position;
+	}
+
+	if (m_position >= m_end) {
+		return false;
+	}
+
+	*key = start;
+	*length = static_cast<int>(m_position - start);
+
+	++m_position;
+
+	return true;
+}
+
+bool MessageReader::ReadString(QString* value) {
+	if (!Consume('"')) {
+		return false;
+	}
+
+	const char* start = m_position;
+
+	while (m_position < m_end) {
+		char c = *m_position;
+
+		if (c == '"') {
+			*value = QString::fromUtf8(start, static_cast<int>(m_position - start));
+
+			++m_position;
+
+			return true;
+		}
+
+		if (c == '\\') {
+			break;
+		}
+
+		if (static_cast<unsigned char>(c) < 0x20) {
+			return false;
+		}
+
+		++m_position;
+	}
+
+	if (m_position >= m_end) {
+		return false;
+	}
+
+	QByteArray buffer(start, static_cast<int>(m_position - start));
+
+	while (m_position < m_end) {
+		char c = *m_position++;
+
+		if (c == '"') {
+			*value = QString::fromUtf8(buffer);
+
+			return true;
+		}
+
+		if (static_cast<unsigned char>(c) < 0x20) {
+			return false;
+		}
+
+		if (c != '\\') {
+			buffer.append(c);
+			continue;
+		}
+
+		if (m_position >= m_end) {
+			return false;
+		}
+
+		c = *m_position++;
+
+		switch (c) {
+			case '"':
+			case '\\':
+			case '/':
+				buffer.append(c);
+				break;
+
+			case 'b':
+				buffer.append('\b');
+				break;
+
+			case 'f':
+				buffer.append('\f');
+				break;
+
+			case 'n':
+				buffer.append('\n');
+				break;
+
+			case 'r':
+				buffer.append('\r');
+				break;
+
+			case 't':
+				buffer.append('\t');
+				break;
+
+			case 'u': {
+				uint32_t code;
+
+				if (!ReadHex(&code)) {
+					return false;
+				}
+
+				if (code >= 0xdc00 && code <= 0xdfff) {
+					return false;
+				}
+
+				if (code >= 0xd800 && code <= 0xdbff) {
+					uint32_t low;
+
+					if (!Consume('\\') || !Consume('u') || !ReadHex(&low)) {
+						return false;
+					}
+
+					if (low < 0xdc00 || low > 0xdfff) {
+						return false;
+					}
+
+					code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+				}
+
+				AppendUTF8(&buffer, code);
+				break;
+			}
+
+			default:
+				return false;
+		}
+	}
+
+	return false;
+}
+
+bool MessageReader::ReadStringField(QString* value) {
+	if (Peek('"')) {
+		return ReadString(value);
+	}
+
+	value->clear();
+
+	return SkipValue();
+}
+
+bool MessageReader::ReadTypeField(bool* incoming) {
+	if (!Peek('"')) {
+		*incoming = false;
+
+		return SkipValue();
+	}
+
+	const char* type;
+	int length;
+
+	if (!ReadKey(&type, &length)) {
+		return false;
+	}
+
+	*incoming = KeyEquals(type, length, "in");
+
+	return true;
+}
+
+bool MessageReader::ReadDateField(QDateTime* date) {
+	const char* value = m_position;
+	int length;
+
+	bool success;
+
+	if (Peek('"')) {
+		success = ReadKey(&value, &length);
+	} else {
+		success = SkipValue();
+		length = static_cast<int>(m_position - value);
+	}
+
+	if (!success || !DecodeDate(value, length, date)) {
+		*date = QDateTime();
+	}
+
+	return success;
+}
+
+bool MessageReader::ReadBoolField(bool* value) {
+	if (Peek('t')) {
+		*value = true;
+
+		return SkipLiteral("true");
+	}
+
+	if (Peek('f')) {
+		*value = false;
+
+		return SkipLiteral("false");
+	}
+
+	*value = false;
+
+	return SkipValue();
+}
+
+bool MessageReader::ReadIntField(int* value) {
+	qint64 number;
+
+	if (!ReadInt64Field(&number)) {
+		return false;
+	}
+
+	if (number >= std::numeric_limits<int>::min()
+			&& number <= std::numeric_limits<int>::max()) {
+		*value = static_cast<int>(number);
+	} else {
+		*value = 0;
+	}
+
+	return true;
+}
+
+bool MessageReader::ReadInt64Field(qint64* value) {
+	if (Peek('-') || (m_position < m_end && *m_position >= '0' && *m_position <= '9')) {
+		bool integral;
+		int64_t number;
+
+		if (!SkipNumber(&integral, &number)) {
+			return false;
+		}
+
+		*value = integral ? number : 0;
+
+		return true;
+	}
+
+	*value = 0;
+
+	return SkipValue();
+}
+
+bool MessageReader::ReadHex(uint32_t* value) {
+	if (m_end - m_position < 4) {
+		return false;
+	}
+
+	*value = 0;
+
+	for (int i = 0; i < 4; ++i) {
+		char c = *m_position++;
+
+		*value <<= 4;
+
+		if (c >= '0' && c <= '9') {
+			*value |= static_cast<uint32_t>(c - '0');
+		} else if (c >= 'a' && c <= 'f') {
+			*value |= static_cast<uint32_t>(c - 'a' + 10);
+		} else if (c >= 'A' && c <= 'F') {
+			*value |= static_cast<uint32_t>(c - 'A' + 10);
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool MessageReader::SkipValue() {
+	if (m_position >= m_end) {
+		return false;
+	}
+
+	switch (*m_position) {
+		case '"':
+			return SkipString();
+
+		case 't':
+			return SkipLiteral("true");
+
+		case 'f':
+			return SkipLiteral("false");
+
+		case 'n':
+			return SkipLiteral("null");
+
+		case '{':
+		case '[': {
+			bool object = (*m_position == '{');
+			char close = object ? '}' : ']';
+
+			if (++m_depth > MAX_DEPTH) {
+				return false;
+			}
+
+			++m_position;
+
+			SkipWhitespace();
+
+			if (!Consume(close)) {
+				do {
+					SkipWhitespace();
+
+					if (object) {
+						if (!SkipString()) {
+							return false;
+						}
+
+						SkipWhitespace();
+
+						if (!Consume(':')) {
+							return false;
+						}
+
+						SkipWhitespace();
+					}
+
+					if (!SkipValue()) {
+						return false;
+					}
+
+					SkipWhitespace();
+				} while (Consume(','));
+
+				if (!Consume(close)) {
+					return false;
+				}
+			}
+
+			--m_depth;
+
+			return true;
+		}
+
+		default:
+			return SkipNumber();
+	}
+}
+
+bool MessageReader::SkipString() {
+	if (!Consume('"')) {
+		return false;
+	}
+
+	while (m_position < m_end) {
+		char c = *m_position++;
+
+		if (c == '"') {
+			return true;
+		}
+
+		if (static_cast<unsigned char>(c) < 0x20) {
+			return false;
+		}
+
+		if (c == '\\') {
+			if (m_position >= m_end) {
+				return false;
+			}
+
+			++m_position;
+		}
+	}
+
+	return false;
+}
+
+bool MessageReader::SkipLiteral(const char* literal) {
+	size_t length = strlen(literal);
+
+	if (static_cast<size_t>(m_end - m_position) < length
+			|| memcmp(m_position, literal, length) != 0) {
+		return false;
+	}
+
+	m_position += length;
+
+	return true;
+}
+
+bool MessageReader::SkipNumber(bool* integral, int64_t* value) {
+	bool negative = Consume('-');
+	bool isIntegral = true;
+
+	int64_t result = 0;
+
+	const char* digits = m_position;
+
+	while (m_position < m_end && *m_position >= '0' && *m_position <= '9') {
+		if (result > (std::numeric_limits<int64_t>::max() - 9) / 10) {
+			isIntegral = false;
+		} else {
+			result = result * 10 + (*m_position - '0');
+		}
+
+		++m_position;
+	}
+
+	if (m_position == digits) {
+		return false;
+	}
+
+	if (Consume('.')) {
+		const char* fraction = m_position;
+
+		while (m_position < m_end && *m_position >= '0' && *m_position <= '9') {
+			if (*m_position != '0') {
+				isIntegral = false;
+			}
+
+			++m_position;
+		}
+
+		if (m_position == fraction) {
+			return false;
+		}
+	}
+
+	if (Consume('e') || Consume('E')) {
+		if (!Consume('+')) {
+			Consume('-');
+		}
+
+		const char* exponent = m_position;
+
+		while (m_position < m_end && *m_position >= '0' && *m_position <= '9') {
+			++m_position;
+		}
+
+		if (m_position == exponent) {
+			return false;
+		}
+
+		isIntegral = false;
+	}
+
+	if (integral != nullptr) {
+		*integral = isIntegral;
+	}
+
+	if (value != nullptr) {
+		*value = negative ? -result : result;
+	}
+
+	return true;
+}
+
+void MessageReader::SkipWhitespace() {
+	while (m_position < m_end
+			&& (*m_position == ' '
+				|| *m_position == '\t'
+				|| *m_position == '\n'
+				|| *m_position == '\r')) {
+		++m_position;
+	}
+}
+
+bool MessageReader::Consume(char c) {
+	if (!Peek(c)) {
+		return false;
+	}
+
+	++m_position;
+
+	return true;
+}
+
+bool MessageReader::Peek(char c) {
+	return (m_position < m_end && *m_position == c);
+}
+
+StreamedType MessageReader::GetType(const char* type, int length) {
+	uint32_t hash = 2166136261U;
+
+	for (int i = 0; i < length; ++i) {
+		hash = (hash ^ static_cast<uint8_t>(type[i])) * 16777619U;
+	}
+
+	switch (hash) {
+		case MessageTypeHash("notification_received"):
+			if (KeyEquals(type, length, "notification_received")) {
+				return StreamedType::NOTIFICATION_RECEIVED;
+			}
+
+			break;
+
+		case MessageTypeHash("notification_removed"):
+			if (KeyEquals(type, length, "notification_removed")) {
+				return StreamedType::NOTIFICATION_REMOVED;
+			}
+
+			break;
+
+		case MessageTypeHash("notification_list"):
+			if (KeyEquals(type, length, "notification_list")) {
+				return StreamedType::NOTIFICATION_LIST;
+			}
+
+			break;
+
+		case MessageTypeHash("sms_list"):
+			if (KeyEquals(type, length, "sms_list")) {
+				return StreamedType::SMS_LIST;
+			}
+
+			break;
+
+		case MessageTypeHash("sms_from_list"):
+			if (KeyEquals(type, length, "sms_from_list")) {
+				return StreamedType::SMS_FROM_LIST;
+			}
+
+			break;
+
+		default:
+			break;
+	}
+
+	return StreamedType::NONE;
+}
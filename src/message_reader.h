@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <QString>
+#include <QByteArray>
+
+#include "messages.h"
+
+/*
+ * Single pass JSON reader for high-volume inbound messages
+ *
+ * Decodes UTF-8 directly into the Notification/SMS/ShortSMS items of the
+ * message batches as each object is read. Read() returns false for
+ * anything it does not handle, including a list that comes before the
+ * message type, so the caller can fall back to QJsonDocument.
+ */
+
+class MessageReader {
+	public:
+		static bool Read(const QByteArray& data, StreamedMessage* message);
+
+	private:
+		static const int MAX_DEPTH = 64;
+
+		const char* m_position;
+		const char* m_end;
+		int m_depth;
+
+		MessageReader(const char* begin, const char* end);
+
+		bool ReadMessage(StreamedMessage* message);
+		bool ReadNotification(Notification* notification, bool* valid);
+		bool ReadSMS(SMS* sms, bool* valid);
+		bool ReadShortSMS(ShortSMS* shortSms, bool* valid);
+		bool ReadStringList(Batch<QString>* list);
+
+		template<typename T>
+		bool ReadList(Batch<T>* list, bool (MessageReader::*readItem)(T*, bool*));
+
+		template<typename Handler>
+		bool ReadObject(Handler handler);
+
+		bool ReadKey(const char** key, int* length);
+		bool ReadString(QString* value);
+		bool ReadStringField(QString* value);
+		bool ReadTypeField(bool* incoming);
+		bool ReadDateField(QDateTime* date);
+		bool ReadBoolField(bool* value);
+		bool ReadIntField(int* value);
+		bool ReadInt64Field(qint64* value);
+		bool ReadHex(uint32_t* value);
+
+		bool SkipValue();
+		bool SkipString();
+		bool SkipLiteral(const char* literal);
+		bool SkipNumber(bool* integral = nullptr, int64_t* value = nullptr);
+		void SkipWhitespace();
+
+		bool Consume(char c);
+		bool Peek(char c);
+
+		static StreamedType GetType(const char* type, int length);
+};
@@ -0,0 +1,343 @@
+#include <cstring>
+#include <sodium/utils.h>
+#include <sodium/randombytes.h>
+
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+
+#include "message_store.h"
+#include "messages.h"
+#include "crypto.h"
+
+#define HEADER_SIZE     (sizeof(MAGIC) + 1)
+#define NONCE_SIZE      crypto_aead_xchacha20poly1305_ietf_NPUBBYTES
+#define SUBKEY_ID       1
+
+const char MessageStore::MAGIC[4] = {'O', 'P', 'B', 'S'};
+
+static void WriteDate(QDataStream& stream, const QDateTime& date) {
+	stream << date.isValid() << (date.isValid() ? date.toSecsSinceEpoch() : 0);
+}
+
+static QDateTime ReadDate(QDataStream& stream) {
+	bool valid;
+	qint64 seconds;
+
+	stream >> valid >> seconds;
+
+	return valid ? DateFromEpoch(seconds) : QDateTime();
+}
+
+static void WriteShortSMSList(QDataStream& stream, const Batch<ShortSMS>& list) {
+	stream << static_cast<qint32>(list.Size());
+
+	for (const ShortSMS& shortSms : list) {
+		stream << shortSms.incoming;
+		WriteDate(stream, shortSms.date);
+		stream << shortSms.body;
+	}
+}
+
+static qint32 ReadSize(QDataStream& stream) {
+	qint32 size;
+
+	stream >> size;
+
+	if (size < 0) {
+		stream.setStatus(QDataStream::ReadCorruptData);
+
+		return 0;
+	}
+
+	return size;
+}
+
+static bool ReadShortSMSList(QDataStream& stream, Batch<ShortSMS>* list) {
+	qint32 size = ReadSize(stream);
+
+	if (stream.status() != QDataStream::Ok) {
+		return false;
+	}
+
+	list->Reserve(size);
+
+	for (qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+		ShortSMS shortSms;
+
+		stream >> shortSms.incoming;
+		shortSms.date = ReadDate(stream);
+		stream >> shortSms.body;
+
+		list->Append(std::move(shortSms));
+	}
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+static bool ReadContent(const QByteArray& plain, MessageStore::Content* content) {
+	QDataStream stream(plain);
+	stream.setVersion(QDataStream::Qt_5_12);
+
+	stream >> content->clientIdentifier;
+
+	qint32 size = ReadSize(stream);
+
+	content->notifications.Reserve(size);
+
+	for (qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+		Notification notification;
+		QString appName;
+
+		stream >> notification.persistent
+			   >> notification.key
+			   >> appName
+			   >> notification.title
+			   >> notification.text;
+
+		notification.appName = InternedString(appName);
+
+		content->notifications.Append(std::move(notification));
+	}
+
+	size = ReadSize(stream);
+
+	content->smsList.Reserve(size);
+
+	for (qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+		SMS sms;
+		QString number;
+		QString name;
+
+		stream >> sms.incoming;
+		sms.date = ReadDate(stream);
+		stream >> sms.body >> number >> name;
+
+		sms.number = InternedString(number);
+		sms.name = InternedString(name);
+
+		content->smsList.Append(std::move(sms));
+	}
+
+	size = ReadSize(stream);
+
+	for (qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+		SMSCache::Thread thread;
+
+		stream >> thread.number >> thread.name;
+
+		if (!ReadShortSMSList(stream, &thread.list)) {
+			break;
+		}
+
+		content->threads.push_back(std::move(thread));
+	}
+
+	stream >> content->searchIdentifier;
+
+	size = ReadSize(stream);
+
+	content->documents.reserve(static_cast<size_t>(size));
+
+	for (qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+		SearchIndex::Document document;
+		quint8 source;
+
+		stream >> source;
+
+		if (source > static_cast<quint8>(SearchIndex::Source::SMS)) {
+			stream.setStatus(QDataStream::ReadCorruptData);
+
+			break;
+		}
+
+		document.date = ReadDate(stream);
+		stream >> document.origin >> document.title >> document.text;
+
+		document.source = static_cast<SearchIndex::Source>(source);
+
+		content->documents.push_back(std::move(document));
+	}
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+
+MessageStore::MessageStore(const QString& path, const QString& secretKeyHex)
+	: m_path(path) {
+	Crypto::DeriveStorageKey(secretKeyHex, SUBKEY_ID, m_key, sizeof(m_key));
+}
+
+MessageStore::~MessageStore() {
+	sodium_memzero(m_key, sizeof(m_key));
+}
+
+bool MessageStore::Load(Content* content, std::string* error) const {
+	QFile file(m_path);
+
+	if (!file.exists()) {
+		if (error != nullptr) {
+			*error = "No store";
+		}
+
+		return false;
+	}
+
+	if (!file.open(QIODevice::ReadOnly)) {
+		if (error != nullptr) {
+			*error = "Failed to open store";
+		}
+
+		return false;
+	}
+
+	/* The whole file is one authenticated message, it is read at once */
+	QByteArray fileData = file.readAll();
+
+	file.close();
+
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(fileData.constData());
+	qint64 fileSize = fileData.size();
+
+	if (fileSize < static_cast<qint64>(HEADER_SIZE + NONCE_SIZE
+									   + crypto_aead_xchacha20poly1305_ietf_ABYTES)) {
+		if (error != nullptr) {
+			*error = "Invalid store";
+		}
+
+		return false;
+	}
+
+	if (memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || data[sizeof(MAGIC)] != VERSION) {
+		if (error != nullptr) {
+			*error = "Unknown store format";
+		}
+
+		return false;
+	}
+
+	size_t cipherLen = static_cast<size_t>(fileSize) - HEADER_SIZE - NONCE_SIZE;
+
+	QByteArray plain(static_cast<int>(cipherLen - crypto_aead_xchacha20poly1305_ietf_ABYTES),
+					 Qt::Uninitialized);
+
+	unsigned long long plainLen;
+
+	if (crypto_aead_xchacha20poly1305_ietf_decrypt(
+					reinterpret_cast<unsigned char*>(plain.data()),
+					&plainLen,
+					nullptr,
+					(data + HEADER_SIZE + NONCE_SIZE),
+					cipherLen,
+					data,
+					HEADER_SIZE,
+					(data + HEADER_SIZE),
+					m_key) != 0) {
+		if (error != nullptr) {
+			*error = "Store decryption failed";
+		}
+
+		return false;
+	}
+
+	bool valid = ReadContent(plain, content);
+
+	/* The stream is gone, nothing shares the buffer any more */
+	sodium_memzero(plain.data(), static_cast<size_t>(plain.size()));
+
+	if (!valid) {
+		if (error != nullptr) {
+			*error = "Corrupted store";
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+bool MessageStore::Save(const Content& content, std::string* error) const {
+	QByteArray plain;
+
+	QDataStream stream(&plain, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_12);
+
+	stream << content.clientIdentifier;
+
+	stream << static_cast<qint32>(content.notifications.Size());
+
+	for (const Notification& notification : content.notifications) {
+		stream << notification.persistent
+			   << notification.key
+			   << notification.appName.String()
+			   << notification.title
+			   << notification.text;
+	}
+
+	stream << static_cast<qint32>(content.smsList.Size());
+
+	for (const SMS& sms : content.smsList) {
+		stream << sms.incoming;
+		WriteDate(stream, sms.date);
+		stream << sms.body << sms.number.String() << sms.name.String();
+	}
+
+	stream << static_cast<qint32>(content.threads.size());
+
+	for (const SMSCache::Thread& thread : content.threads) {
+		stream << thread.number << thread.name;
+
+		WriteShortSMSList(stream, thread.list);
+	}
+
+	stream << content.searchIdentifier;
+
+	stream << static_cast<qint32>(content.documents.size());
+
+	for (const SearchIndex::Document& document : content.documents) {
+		stream << static_cast<quint8>(document.source);
+		WriteDate(stream, document.date);
+		stream << document.origin << document.title << document.text;
+	}
+
+	QByteArray data(static_cast<int>(HEADER_SIZE + NONCE_SIZE
+									 + static_cast<size_t>(plain.size())
+									 + crypto_aead_xchacha20poly1305_ietf_ABYTES),
+					Qt::Uninitialized);
+
+	unsigned char* buffer = reinterpret_cast<unsigned char*>(data.data());
+
+	memcpy(buffer, MAGIC, sizeof(MAGIC));
+	buffer[sizeof(MAGIC)] = VERSION;
+
+	randombytes_buf((buffer + HEADER_SIZE), NONCE_SIZE);
+
+	unsigned long long cipherLen;
+
+	crypto_aead_xchacha20poly1305_ietf_encrypt(
+				(buffer + HEADER_SIZE + NONCE_SIZE),
+				&cipherLen,
+				reinterpret_cast<const unsigned char*>(plain.constData()),
+				static_cast<size_t>(plain.size()),
+				buffer,
+				HEADER_SIZE,
+				nullptr,
+				(buffer + HEADER_SIZE),
+				m_key);
+
+	sodium_memzero(plain.data(), static_cast<size_t>(plain.size()));
+
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly)
+			|| file.write(data) != data.size()
+			|| !file.commit()) {
+		if (error != nullptr) {
+			*error = "Failed to write store";
+		}
+
+		return false;
+	}
+
+	return true;
+}
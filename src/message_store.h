@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <QString>
+
+#include <sodium/crypto_aead_xchacha20poly1305.h>
+
+#include "common.h"
+#include "batch.h"
+#include "sms_cache.h"
+#include "search_index.h"
+
+/*
+ * Encrypted on-disk copy of the last known phone content
+ *
+ * Restored at startup so the tabs can show it before the phone connects.
+ * The key is derived from the server secret key, regenerating the key
+ * pair makes any existing store unreadable.
+ */
+
+class MessageStore {
+	public:
+		struct Content {
+			QString clientIdentifier;
+			Batch<Notification> notifications;
+			Batch<SMS> smsList;
+			std::vector<SMSCache::Thread> threads;
+			QString searchIdentifier;
+			std::vector<SearchIndex::Document> documents;
+		};
+
+		MessageStore(const QString& path, const QString& secretKeyHex);
+		~MessageStore();
+
+		bool Load(Content* content, std::string* error = nullptr) const;
+		bool Save(const Content& content, std::string* error = nullptr) const;
+
+	private:
+		static const char MAGIC[4];
+		static const unsigned char VERSION = 2;
+
+		QString m_path;
+
+		unsigned char m_key[crypto_aead_xchacha20poly1305_ietf_KEYBYTES];
+};
@@ -0,0 +1,286 @@
+#include <QJsonArray>
+
+#include "messages.h"
+
+#define EPOCH_MS_THRESHOLD  100000000000LL
+
+static inline ushort CodeAt(const char* data, int i) {
+	return static_cast<uchar>(data[i]);
+}
+
+static inline ushort CodeAt(const QChar* data, int i) {
+	return data[i].unicode();
+}
+
+template<typename Char>
+static int ReadDigits(const Char* data, int count) {
+	int value = 0;
+
+	for (int i = 0; i < count; ++i) {
+		ushort c = CodeAt(data, i);
+
+		if (c < '0' || c > '9') {
+			return -1;
+		}
+
+		value = value * 10 + (c - '0');
+	}
+
+	return value;
+}
+
+/*
+ * Shared by the Latin-1 and UTF-16 paths so that neither converts to the other
+ */
+
+template<typename Char>
+static bool ParseDate(const Char* data, int length, QDateTime* date) {
+	if (length == 20) {
+		if (CodeAt(data, 4) != '-' || CodeAt(data, 7) != '-' || CodeAt(data, 10) != 'T'
+				|| CodeAt(data, 13) != ':' || CodeAt(data, 16) != ':' || CodeAt(data, 19) != 'Z') {
+			return false;
+		}
+
+		/* Same fields QDateTime::fromString(DATE_FORMAT) reads, in local time */
+		QDate day(ReadDigits(data, 4), ReadDigits(data + 5, 2), ReadDigits(data + 8, 2));
+		QTime time(ReadDigits(data + 11, 2), ReadDigits(data + 14, 2), ReadDigits(data + 17, 2));
+
+		if (!day.isValid() || !time.isValid()) {
+			return false;
+		}
+
+		*date = QDateTime(day, time, Qt::LocalTime);
+
+		return true;
+	}
+
+	if (length < 1 || length > 15) {
+		return false;
+	}
+
+	qint64 value = 0;
+
+	for (int i = 0; i < length; ++i) {
+		ushort c = CodeAt(data, i);
+
+		if (c < '0' || c > '9') {
+			return false;
+		}
+
+		value = value * 10 + (c - '0');
+	}
+
+	*date = DateFromEpoch((value >= EPOCH_MS_THRESHOLD) ? (value / 1000) : value);
+
+	return true;
+}
+
+bool DecodeDate(const char* data, int length, QDateTime* date) {
+	return ParseDate(data, length, date);
+}
+
+bool DecodeDate(QStringView str, QDateTime* date) {
+	if (str.size() > 20) {
+		return false;
+	}
+
+	return ParseDate(str.data(), static_cast<int>(str.size()), date);
+}
+
+bool DecodeDate(const QJsonValue& value, QDateTime* date) {
+	if (value.isDouble()) {
+		double epoch = value.toDouble();
+
+		if (epoch < 0 || epoch >= EPOCH_MS_THRESHOLD * 1000) {
+			return false;
+		}
+
+		qint64 seconds = static_cast<qint64>(epoch);
+
+		*date = DateFromEpoch((seconds >= EPOCH_MS_THRESHOLD) ? (seconds / 1000) : seconds);
+
+		return true;
+	}
+
+	if (!value.isString()) {
+		return false;
+	}
+
+	/* toString() only takes a reference on the string the value holds */
+	const QString str = value.toString();
+
+	return DecodeDate(QStringView(str), date);
+}
+
+/*
+ * Epochs are shown in local time, like the dates the phone sends as fields
+ */
+
+QDateTime DateFromEpoch(qint64 seconds) {
+	return QDateTime::fromSecsSinceEpoch(seconds);
+}
+
+bool DecodeNotification(const QJsonObject& json, Notification* notification) {
+	if (!json.contains("key")
+			|| !json.contains("app_name")
+			|| !json.contains("title")) {
+		return false;
+	}
+
+	notification->persistent = json.value("persistent").toBool(false);
+	notification->key = json.value("key").toString();
+	notification->appName = InternedString(json.value("app_name").toString());
+	notification->title = json.value("title").toString();
+	notification->text = json.value("text").toString();
+
+	return (!notification->key.isEmpty()
+			&& !notification->appName.IsNull()
+			&& !notification->title.isEmpty());
+}
+
+bool DecodeSMS(const QJsonObject& json, SMS* sms) {
+	if (!json.contains("type")
+			|| !json.contains("date")
+			|| !json.contains("body")
+			|| !json.contains("number")) {
+		return false;
+	}
+
+	sms->incoming = (json.value("type").toString() == "in");
+	sms->body = json.value("body").toString();
+	sms->number = InternedString(json.value("number").toString());
+	sms->name = InternedString(json.value("name").toString());
+
+	if (!DecodeDate(json.value("date"), &sms->date)) {
+		return false;
+	}
+
+	return !sms->number.IsNull();
+}
+
+bool DecodeShortSMS(const QJsonObject& json, ShortSMS* shortSms) {
+	if (!json.contains("type")
+			|| !json.contains("date")
+			|| !json.contains("body")) {
+		return false;
+	}
+
+	shortSms->incoming = (json.value("type").toString() == "in");
+	shortSms->body = json.value("body").toString();
+
+	if (!DecodeDate(json.value("date"), &shortSms->date)) {
+		shortSms->date = QDateTime();
+	}
+
+	return true;
+}
+
+static qint64 DecodeSequence(const QJsonValue& value) {
+	double sequence = value.toDouble(0);
+
+	return (sequence > 0) ? static_cast<qint64>(sequence) : 0;
+}
+
+bool NotificationMessage::Decode(const QJsonObject& json, NotificationMessage* message) {
+	message->sequence = DecodeSequence(json.value("seq"));
+
+	return DecodeNotification(json.value("notification").toObject(), &message->notification);
+}
+
+bool NotificationListMessage::Decode(const QJsonObject& json, NotificationListMessage* message) {
+	message->sequence = DecodeSequence(json.value("seq"));
+	message->since = DecodeSequence(json.value("since"));
+	message->delta = json.value("delta").toBool(false);
+
+	QJsonArray jsonRemoved = json.value("removed").toArray();
+
+	message->removed.Reserve(jsonRemoved.size());
+
+	for (const QJsonValue& key : jsonRemoved) {
+		if (key.isString()) {
+			message->removed.Append(key.toString());
+		}
+	}
+
+	QJsonArray jsonList = json.value("list").toArray();
+
+	message->list.Reserve(jsonList.size());
+
+	auto iterator = jsonList.begin();
+
+	while (iterator != jsonList.end()) {
+		Notification notification;
+
+		if (DecodeNotification(iterator->toObject(), &notification)) {
+			message->list.Append(std::move(notification));
+		}
+
+		++iterator;
+	}
+
+	return true;
+}
+
+bool SMSListMessage::Decode(const QJsonObject& json, SMSListMessage* message) {
+	QJsonArray jsonList = json.value("list").toArray();
+
+	message->list.Reserve(jsonList.size());
+
+	auto iterator = jsonList.begin();
+
+	while (iterator != jsonList.end()) {
+		SMS sms;
+
+		if (DecodeSMS(iterator->toObject(), &sms)) {
+			message->list.Append(std::move(sms));
+		}
+
+		++iterator;
+	}
+
+	return true;
+}
+
+bool SMSFromListMessage::Decode(const QJsonObject& json, SMSFromListMessage* message) {
+	message->number = json.value("number").toString();
+	message->page = json.value("page").toInt();
+
+	if (message->number.isEmpty()) {
+		return false;
+	}
+
+	message->name = json.value("name").toString();
+
+	QJsonArray jsonList = json.value("list").toArray();
+
+	message->list.Reserve(jsonList.size());
+
+	auto iterator = jsonList.begin();
+
+	while (iterator != jsonList.end()) {
+		ShortSMS shortSms;
+
+		if (DecodeShortSMS(iterator->toObject(), &shortSms) && shortSms.date.isValid()) {
+			message->list.Append(std::move(shortSms));
+		}
+
+		++iterator;
+	}
+
+	return true;
+}
+
+bool SMSSentMessage::Decode(const QJsonObject& json, SMSSentMessage* message) {
+	message->number = json.value("number").toString();
+	message->success = json.value("success").toBool();
+
+	if (message->number.isEmpty()) {
+		return false;
+	}
+
+	return DecodeShortSMS(json.value("sms").toObject(), &message->sms);
+}
+
+bool SMSReceivedMessage::Decode(const QJsonObject& json, SMSReceivedMessage* message) {
+	return DecodeSMS(json.value("sms").toObject(), &message->sms);
+}
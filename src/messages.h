@@ -0,0 +1,139 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <QString>
+#include <QDateTime>
+#include <QStringView>
+#include <QJsonValue>
+#include <QJsonObject>
+
+#include "common.h"
+#include "batch.h"
+
+/*
+ * Inbound message types handled by the bridge, in the form
+ * X(type, message struct, Bridge handler)
+ */
+
+#define BRIDGE_MESSAGES(X) \
+	X("notification_received",  NotificationMessage,        OnNotificationReceived) \
+	X("notification_removed",   NotificationMessage,        OnNotificationRemoved) \
+	X("notification_list",      NotificationListMessage,    OnNotificationList) \
+	X("sms_list",               SMSListMessage,             OnSMSList) \
+	X("sms_from_list",          SMSFromListMessage,         OnSMSFromList) \
+	X("sms_sent",               SMSSentMessage,             OnSMSSent) \
+	X("sms_received",           SMSReceivedMessage,         OnSMSReceived)
+
+/*
+ * FNV-1a hash of a message type
+ *
+ * Used as switch labels by the dispatcher, so a collision between two
+ * registered types is a compile error.
+ */
+
+constexpr uint32_t MessageTypeHash(const char* type, uint32_t hash = 2166136261U) {
+	return (*type == '\0')
+		   ? hash
+		   : MessageTypeHash(type + 1, (hash ^ static_cast<uint8_t>(*type)) * 16777619U);
+}
+
+inline uint32_t MessageTypeHash(const QString& type) {
+	uint32_t hash = 2166136261U;
+
+	for (const QChar& c : type) {
+		hash = (hash ^ c.unicode()) * 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * Notification messages carry the phone's change sequence in "seq", 0 when
+ * the phone does not number its changes. A delta list only holds the
+ * notifications added or updated since "since", and the keys removed.
+ */
+
+struct NotificationMessage {
+	Notification notification;
+	qint64 sequence;
+
+	static bool Decode(const QJsonObject& json, NotificationMessage* message);
+};
+
+struct NotificationListMessage {
+	Batch<Notification> list;
+	Batch<QString> removed;
+	qint64 sequence;
+	qint64 since;
+	bool delta;
+
+	static bool Decode(const QJsonObject& json, NotificationListMessage* message);
+};
+
+struct SMSListMessage {
+	Batch<SMS> list;
+
+	static bool Decode(const QJsonObject& json, SMSListMessage* message);
+};
+
+struct SMSFromListMessage {
+	QString number;
+	QString name;
+	int page;
+	Batch<ShortSMS> list;
+
+	static bool Decode(const QJsonObject& json, SMSFromListMessage* message);
+};
+
+struct SMSSentMessage {
+	QString number;
+	bool success;
+	ShortSMS sms;
+
+	static bool Decode(const QJsonObject& json, SMSSentMessage* message);
+};
+
+struct SMSReceivedMessage {
+	SMS sms;
+
+	static bool Decode(const QJsonObject& json, SMSReceivedMessage* message);
+};
+
+/*
+ * Messages decoded by MessageReader without going through QJsonDocument
+ */
+
+enum class StreamedType : uint8_t {
+	NONE = 0,
+	NOTIFICATION_RECEIVED,
+	NOTIFICATION_REMOVED,
+	NOTIFICATION_LIST,
+	SMS_LIST,
+	SMS_FROM_LIST
+};
+
+struct StreamedMessage {
+	StreamedType type;
+	NotificationMessage notification;
+	NotificationListMessage notificationList;
+	SMSListMessage smsList;
+	SMSFromListMessage smsFromList;
+};
+
+/*
+ * Decode a DATE_FORMAT date into a local time date without going through
+ * QDateTime::fromString
+ *
+ * Integer epochs are accepted as well, in seconds or in milliseconds
+ * (anything past year 5000 in seconds is taken as milliseconds).
+ */
+
+bool DecodeDate(const char* data, int length, QDateTime* date);
+bool DecodeDate(QStringView str, QDateTime* date);
+bool DecodeDate(const QJsonValue& value, QDateTime* date);
+QDateTime DateFromEpoch(qint64 seconds);
+
+bool DecodeNotification(const QJsonObject& json, Notification* notification);
+bool DecodeSMS(const QJsonObject& json, SMS* sms);
+bool DecodeShortSMS(const QJsonObject& json, ShortSMS* shortSms);
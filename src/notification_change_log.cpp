@@ -0,0 +1,81 @@
+#include <algorithm>
+
+#include "notification_change_log.h"
+
+void NotificationChangeLog::Received(const Notification& notification) {
+	auto iterator = m_entries.find(notification.key);
+
+	if (iterator == m_entries.end()) {
+		Entry entry;
+		entry.removed = false;
+		entry.present = true;
+		entry.notification = notification;
+
+		m_entries.insert(notification.key, entry);
+		m_order.push_back(notification.key);
+		return;
+	}
+
+	if (!iterator->present) {
+		/* Posted again after a removal, it goes back on top */
+		m_order.erase(std::remove(m_order.begin(), m_order.end(), notification.key), m_order.end());
+		m_order.push_back(notification.key);
+
+		iterator->present = true;
+	}
+
+	iterator->notification = notification;
+}
+
+void NotificationChangeLog::Removed(const QString& key) {
+	auto iterator = m_entries.find(key);
+
+	if (iterator == m_entries.end()) {
+		Entry entry;
+		entry.removed = true;
+		entry.present = false;
+
+		m_entries.insert(key, entry);
+		return;
+	}
+
+	iterator->removed = true;
+	iterator->present = false;
+}
+
+void NotificationChangeLog::Clear() {
+	m_entries.clear();
+	m_order.clear();
+}
+
+bool NotificationChangeLog::IsEmpty() const {
+	return m_entries.isEmpty();
+}
+
+QStringList NotificationChangeLog::RemovedKeys() const {
+	QStringList keys;
+
+	for (auto iterator = m_entries.cbegin(); iterator != m_entries.cend(); ++iterator) {
+		if (iterator->removed) {
+			keys.append(iterator.key());
+		}
+	}
+
+	return keys;
+}
+
+std::vector<Notification> NotificationChangeLog::ReceivedNotifications() const {
+	std::vector<Notification> list;
+
+	list.reserve(m_order.size());
+
+	for (const QString& key : m_order) {
+		const Entry& entry = m_entries[key];
+
+		if (entry.present) {
+			list.push_back(entry.notification);
+		}
+	}
+
+	return list;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include "common.h"
+
+/*
+ * Net notification changes not shown yet
+ *
+ * Only the latest state of every key is kept, a notification received
+ * and removed while nothing is shown leaves a removal behind and nothing
+ * else. Received notifications are kept in arrival order.
+ */
+
+class NotificationChangeLog {
+	public:
+		void Received(const Notification& notification);
+		void Removed(const QString& key);
+		void Clear();
+
+		bool IsEmpty() const;
+
+		QStringList RemovedKeys() const;
+		std::vector<Notification> ReceivedNotifications() const;
+
+	private:
+		struct Entry {
+			bool removed;
+			bool present;
+			Notification notification;
+		};
+
+		QHash<QString, Entry> m_entries;
+		std::vector<QString> m_order;
+};
@@ -0,0 +1,287 @@
+#include <cstring>
+#include <algorithm>
+#include <sodium/utils.h>
+#include <sodium/randombytes.h>
+
+#include <QDataStream>
+
+#include "notification_history.h"
+#include "crypto.h"
+
+#define HEADER_SIZE     64
+#define SLOT_HEADER     (8 + 2 + crypto_aead_xchacha20poly1305_ietf_NPUBBYTES)
+#define SLOT_PAYLOAD    (HISTORY_SLOT_SIZE - SLOT_HEADER - crypto_aead_xchacha20poly1305_ietf_ABYTES)
+#define FILE_SIZE       (HEADER_SIZE + static_cast<qint64>(HISTORY_SLOTS) * HISTORY_SLOT_SIZE)
+#define SUBKEY_ID       2
+
+const char NotificationHistory::MAGIC[4] = {'O', 'P', 'B', 'H'};
+
+static void WriteUInt64LE(unsigned char* dest, uint64_t src) {
+	for (int i = 0; i < 8; ++i) {
+		dest[i] = static_cast<unsigned char>(src >> (i * 8));
+	}
+}
+
+static uint64_t ReadUInt64LE(const unsigned char* src) {
+	uint64_t result = 0;
+
+	for (int i = 7; i >= 0; --i) {
+		result = (result << 8) | src[i];
+	}
+
+	return result;
+}
+
+static QByteArray Serialize(const Notification& notification, int textLength) {
+	QByteArray data;
+
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_12);
+
+	stream << QDateTime::currentSecsSinceEpoch()
+		   << notification.persistent
+		   << notification.key
+		   << notification.appName.String()
+		   << ellipsize(notification.title, NOTIF_TITLE_MAX_LENGTH)
+		   << ellipsize(notification.text, textLength);
+
+	return data;
+}
+
+NotificationHistory::NotificationHistory(const QString& path, const QString& secretKeyHex)
+	: m_file(path),
+	  m_data(nullptr),
+	  m_sequence(0),
+	  m_count(0) {
+	Crypto::DeriveStorageKey(secretKeyHex, SUBKEY_ID, m_key, sizeof(m_key));
+
+	if (!Open() && !Create()) {
+		throw std::runtime_error("Failed to open notification history");
+	}
+}
+
+NotificationHistory::~NotificationHistory() {
+	if (m_data != nullptr) {
+		m_file.unmap(m_data);
+	}
+
+	m_file.close();
+
+	sodium_memzero(m_key, sizeof(m_key));
+}
+
+void NotificationHistory::Append(const Notification& notification) {
+	int textLength = NOTIF_TEXT_MAX_LENGTH;
+
+	QByteArray plain = Serialize(notification, textLength);
+
+	while (plain.size() > static_cast<int>(SLOT_PAYLOAD) && textLength > 0) {
+		textLength /= 2;
+
+		plain = Serialize(notification, textLength);
+	}
+
+	if (plain.size() > static_cast<int>(SLOT_PAYLOAD)) {
+		return;
+	}
+
+	uint64_t sequence = m_sequence + 1;
+
+	unsigned char* slot = Slot(sequence);
+
+	/* Invalidate the slot first so a partial write is never read back */
+	WriteUInt64LE(slot, 0);
+
+	unsigned long long cipherLen;
+
+	randombytes_buf((slot + 10), crypto_aead_xchacha20poly1305_ietf_NPUBBYTES);
+
+	unsigned char ad[8];
+
+	WriteUInt64LE(ad, sequence);
+
+	crypto_aead_xchacha20poly1305_ietf_encrypt(
+				(slot + SLOT_HEADER),
+				&cipherLen,
+				reinterpret_cast<const unsigned char*>(plain.constData()),
+				static_cast<size_t>(plain.size()),
+				ad,
+				sizeof(ad),
+				nullptr,
+				(slot + 10),
+				m_key);
+
+	slot[8] = static_cast<unsigned char>(cipherLen & 0xff);
+	slot[9] = static_cast<unsigned char>((cipherLen >> 8) & 0xff);
+
+	WriteUInt64LE(slot, sequence);
+
+	m_sequence = sequence;
+
+	if (m_count < HISTORY_SLOTS) {
+		++m_count;
+	}
+}
+
+uint64_t NotificationHistory::Sequence() const {
+	return m_sequence;
+}
+
+uint64_t NotificationHistory::Read(uint64_t sequence, int count, std::vector<Entry>* entries) const {
+	if (m_count == 0) {
+		return 0;
+	}
+
+	uint64_t oldest = m_sequence - static_cast<uint64_t>(m_count) + 1;
+
+	sequence = std::min(sequence, m_sequence);
+
+	entries->reserve(static_cast<size_t>(count));
+
+	/* Newest first, only the requested slots are decrypted */
+	while (sequence >= oldest && entries->size() < static_cast<size_t>(count)) {
+		Entry entry;
+
+		if (ReadSlot(sequence, &entry)) {
+			entries->push_back(std::move(entry));
+		}
+
+		--sequence;
+	}
+
+	return (sequence >= oldest) ? sequence : 0;
+}
+
+bool NotificationHistory::Open() {
+	if (!m_file.exists() || m_file.size() != FILE_SIZE) {
+		return false;
+	}
+
+	if (!m_file.open(QIODevice::ReadWrite)) {
+		return false;
+	}
+
+	m_data = m_file.map(0, FILE_SIZE);
+
+	if (m_data == nullptr
+			|| memcmp(m_data, MAGIC, sizeof(MAGIC)) != 0
+			|| m_data[sizeof(MAGIC)] != VERSION) {
+		if (m_data != nullptr) {
+			m_file.unmap(m_data);
+			m_data = nullptr;
+		}
+
+		m_file.close();
+
+		return false;
+	}
+
+	/* Only the slot headers are touched to find the most recent entry */
+	for (int i = 0; i < HISTORY_SLOTS; ++i) {
+		uint64_t sequence = ReadUInt64LE(m_data + HEADER_SIZE + static_cast<qint64>(i) * HISTORY_SLOT_SIZE);
+
+		if (sequence > m_sequence) {
+			m_sequence = sequence;
+		}
+
+		if (sequence > 0) {
+			++m_count;
+		}
+	}
+
+	return true;
+}
+
+bool NotificationHistory::Create() {
+	if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+		return false;
+	}
+
+	if (!m_file.resize(FILE_SIZE)) {
+		m_file.close();
+
+		return false;
+	}
+
+	m_data = m_file.map(0, FILE_SIZE);
+
+	if (m_data == nullptr) {
+		m_file.close();
+
+		return false;
+	}
+
+	memset(m_data, 0, static_cast<size_t>(FILE_SIZE));
+	memcpy(m_data, MAGIC, sizeof(MAGIC));
+
+	m_data[sizeof(MAGIC)] = VERSION;
+
+	m_sequence = 0;
+	m_count = 0;
+
+	return true;
+}
+
+unsigned char* NotificationHistory::Slot(uint64_t sequence) const {
+	return m_data + HEADER_SIZE
+		   + static_cast<qint64>(sequence % HISTORY_SLOTS) * HISTORY_SLOT_SIZE;
+}
+
+bool NotificationHistory::ReadSlot(uint64_t sequence, Entry* entry) const {
+	const unsigned char* slot = Slot(sequence);
+
+	if (sequence == 0 || ReadUInt64LE(slot) != sequence) {
+		return false;
+	}
+
+	size_t cipherLen = static_cast<size_t>(slot[8]) | (static_cast<size_t>(slot[9]) << 8);
+
+	if (cipherLen < crypto_aead_xchacha20poly1305_ietf_ABYTES
+			|| cipherLen > HISTORY_SLOT_SIZE - SLOT_HEADER) {
+		return false;
+	}
+
+	unsigned char ad[8];
+
+	WriteUInt64LE(ad, sequence);
+
+	QByteArray plain(static_cast<int>(cipherLen - crypto_aead_xchacha20poly1305_ietf_ABYTES),
+					 Qt::Uninitialized);
+
+	unsigned long long plainLen;
+
+	if (crypto_aead_xchacha20poly1305_ietf_decrypt(
+					reinterpret_cast<unsigned char*>(plain.data()),
+					&plainLen,
+					nullptr,
+					(slot + SLOT_HEADER),
+					cipherLen,
+					ad,
+					sizeof(ad),
+					(slot + 10),
+					m_key) != 0) {
+		return false;
+	}
+
+	QDataStream stream(plain);
+	stream.setVersion(QDataStream::Qt_5_12);
+
+	qint64 timestamp;
+	QString appName;
+
+	stream >> timestamp
+		   >> entry->notification.persistent
+		   >> entry->notification.key
+		   >> appName
+		   >> entry->notification.title
+		   >> entry->notification.text;
+
+	if (stream.status() != QDataStream::Ok) {
+		return false;
+	}
+
+	entry->date = QDateTime::fromSecsSinceEpoch(timestamp);
+	entry->notification.appName = InternedString(appName);
+
+	return true;
+}
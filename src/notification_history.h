@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+#include <stdint.h>
+
+#include <QFile>
+#include <QString>
+#include <QDateTime>
+
+#include <sodium/crypto_aead_xchacha20poly1305.h>
+
+#include "common.h"
+
+/*
+ * Append-only log of posted notifications, updates are not logged
+ *
+ * Stored in a fixed-size memory-mapped ring file, once full the oldest
+ * entries are overwritten. Every slot is encrypted on its own so pages can
+ * be read without touching the rest of the log.
+ */
+
+class NotificationHistory {
+	public:
+		struct Entry {
+			QDateTime date;
+			Notification notification;
+		};
+
+		NotificationHistory(const QString& path, const QString& secretKeyHex);
+		~NotificationHistory();
+
+		void Append(const Notification& notification);
+
+		uint64_t Sequence() const;
+		uint64_t Read(uint64_t sequence, int count, std::vector<Entry>* entries) const;
+
+	private:
+		static const char MAGIC[4];
+		static const unsigned char VERSION = 1;
+
+		QFile m_file;
+		unsigned char* m_data;
+
+		uint64_t m_sequence;
+		int m_count;
+
+		unsigned char m_key[crypto_aead_xchacha20poly1305_ietf_KEYBYTES];
+
+		bool Open();
+		bool Create();
+
+		unsigned char* Slot(uint64_t sequence) const;
+		bool ReadSlot(uint64_t sequence, Entry* entry) const;
+};
@@ -0,0 +1,143 @@
+#include "notification_mirror.h"
+
+NotificationMirror::NotificationMirror()
+	: m_sequence(0),
+	  m_complete(false) {
+}
+
+qint64 NotificationMirror::Sequence() const {
+	return m_sequence;
+}
+
+bool NotificationMirror::IsSynced() const {
+	return (m_sequence > 0);
+}
+
+bool NotificationMirror::IsComplete() const {
+	return m_complete;
+}
+
+void NotificationMirror::Reset() {
+	m_notifications.clear();
+	m_positions.clear();
+
+	m_sequence = 0;
+	m_complete = false;
+}
+
+void NotificationMirror::Assign(const Batch<Notification>& list, qint64 sequence) {
+	Reset();
+
+	m_notifications.reserve(static_cast<size_t>(list.Size()));
+	m_positions.reserve(list.Size());
+
+	auto iterator = list.rbegin();
+
+	while (iterator != list.rend()) {
+		Put(*iterator);
+
+		++iterator;
+	}
+
+	m_sequence = (sequence > 0) ? sequence : 0;
+	m_complete = true;
+}
+
+bool NotificationMirror::ApplyDelta(const Batch<Notification>& list,
+									const Batch<QString>& removed,
+									qint64 since,
+									qint64 sequence) {
+	/*
+	 * Events received while the request was in flight may already be part
+	 * of the delta, applying them twice is harmless
+	 */
+	if (!IsSynced() || since > m_sequence || sequence < m_sequence) {
+		return false;
+	}
+
+	for (const QString& key : removed) {
+		Erase(key);
+	}
+
+	auto iterator = list.rbegin();
+
+	while (iterator != list.rend()) {
+		Put(*iterator);
+
+		++iterator;
+	}
+
+	m_sequence = sequence;
+
+	return true;
+}
+
+void NotificationMirror::Insert(const Notification& notification, qint64 sequence) {
+	Put(notification);
+
+	Advance(sequence);
+}
+
+void NotificationMirror::Remove(const QString& key, qint64 sequence) {
+	Erase(key);
+
+	Advance(sequence);
+}
+
+Batch<Notification> NotificationMirror::Snapshot() const {
+	Batch<Notification> batch;
+
+	batch.Reserve(static_cast<int>(m_notifications.size()));
+
+	auto iterator = m_notifications.rbegin();
+
+	while (iterator != m_notifications.rend()) {
+		batch.Append(*iterator);
+
+		++iterator;
+	}
+
+	return batch;
+}
+
+void NotificationMirror::Advance(qint64 sequence) {
+	if (IsSynced() && sequence == m_sequence + 1) {
+		m_sequence = sequence;
+	} else {
+		m_sequence = 0;
+	}
+}
+
+void NotificationMirror::Put(const Notification& notification) {
+	auto iterator = m_positions.find(notification.key);
+
+	/* Updated where it is, like the notifications tab does */
+	if (iterator != m_positions.end()) {
+		m_notifications[static_cast<size_t>(iterator.value())] = notification;
+		return;
+	}
+
+	m_positions.insert(notification.key, static_cast<int>(m_notifications.size()));
+	m_notifications.push_back(notification);
+}
+
+void NotificationMirror::Erase(const QString& key) {
+	auto iterator = m_positions.find(key);
+
+	if (iterator == m_positions.end()) {
+		return;
+	}
+
+	int position = iterator.value();
+
+	m_positions.erase(iterator);
+	m_notifications.erase(m_notifications.begin() + position);
+
+	UpdatePositions(position);
+}
+
+void NotificationMirror::UpdatePositions(int first) {
+	for (int i = first; i < static_cast<int>(m_notifications.size()); ++i) {
+		m_positions[m_notifications[static_cast<size_t>(i)].key] = i;
+	}
+}
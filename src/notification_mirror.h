@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include <QHash>
+#include <QString>
+
+#include "common.h"
+#include "batch.h"
+
+/*
+ * Local copy of the phone's notification list
+ *
+ * Kept up to date by notification events. The phone numbers every change,
+ * as long as the sequence is contiguous a list request only needs the
+ * changes made since Sequence(). A sequence of 0 means out of sync.
+ *
+ * The mirror is complete once a full list was assigned, before that it
+ * only holds what events reported.
+ */
+
+class NotificationMirror {
+	public:
+		NotificationMirror();
+
+		qint64 Sequence() const;
+		bool IsSynced() const;
+		bool IsComplete() const;
+
+		void Reset();
+		void Assign(const Batch<Notification>& list, qint64 sequence);
+		bool ApplyDelta(const Batch<Notification>& list,
+						const Batch<QString>& removed,
+						qint64 since,
+						qint64 sequence);
+
+		void Insert(const Notification& notification, qint64 sequence);
+		void Remove(const QString& key, qint64 sequence);
+
+		Batch<Notification> Snapshot() const;
+
+	private:
+		/* Most recent last, so new ones are appended */
+		std::vector<Notification> m_notifications;
+		QHash<QString, int> m_positions;
+
+		qint64 m_sequence;
+		bool m_complete;
+
+		void Advance(qint64 sequence);
+		void Put(const Notification& notification);
+		void Erase(const QString& key);
+		void UpdatePositions(int first);
+};
@@ -0,0 +1,139 @@
+#include <vector>
+#include <algorithm>
+
+#include <QSet>
+
+#include "notification_throttle.h"
+
+NotificationThrottle::NotificationThrottle(int interval, QObject* parent)
+	: QObject(parent),
+	  m_timer(nullptr),
+	  m_interval(interval) {
+	m_timer = new QTimer(this);
+
+	connect(m_timer, &QTimer::timeout, this, &NotificationThrottle::Flush);
+
+	m_timer->setSingleShot(true);
+
+	m_clock.start();
+}
+
+void NotificationThrottle::NotificationReceived(const Notification& notification) {
+	qint64 now = m_clock.elapsed();
+
+	auto iterator = m_entries.find(notification.key);
+
+	if (iterator == m_entries.end()) {
+		Entry entry;
+		entry.applied = now;
+		entry.pending = false;
+
+		m_entries.insert(notification.key, entry);
+
+		emit NotificationPosted(notification);
+		return;
+	}
+
+	if (!iterator->pending && now - iterator->applied >= m_interval) {
+		iterator->applied = now;
+
+		emit NotificationUpdated(notification);
+		return;
+	}
+
+	/* Replaces any update still waiting */
+	iterator->notification = notification;
+	iterator->pending = true;
+
+	Schedule();
+}
+
+void NotificationThrottle::NotificationRemoved(const Notification& notification) {
+	m_entries.remove(notification.key);
+}
+
+void NotificationThrottle::NotificationList(const Batch<Notification>& list) {
+	qint64 now = m_clock.elapsed();
+
+	QSet<QString> keys;
+
+	/* The list is newer than anything still waiting */
+	for (const Notification& notification : list) {
+		keys.insert(notification.key);
+
+		auto iterator = m_entries.find(notification.key);
+
+		if (iterator == m_entries.end()) {
+			Entry entry;
+			entry.applied = now;
+			entry.pending = false;
+
+			m_entries.insert(notification.key, entry);
+		} else {
+			iterator->pending = false;
+			iterator->notification = Notification();
+		}
+	}
+
+	auto iterator = m_entries.begin();
+
+	while (iterator != m_entries.end()) {
+		if (!keys.contains(iterator.key())) {
+			iterator = m_entries.erase(iterator);
+		} else {
+			++iterator;
+		}
+	}
+
+	Schedule();
+}
+
+void NotificationThrottle::Clear() {
+	m_timer->stop();
+
+	m_entries.clear();
+}
+
+void NotificationThrottle::Flush() {
+	qint64 now = m_clock.elapsed();
+
+	std::vector<Notification> updates;
+
+	auto iterator = m_entries.begin();
+
+	while (iterator != m_entries.end()) {
+		if (iterator->pending && now - iterator->applied >= m_interval) {
+			iterator->applied = now;
+			iterator->pending = false;
+
+			updates.push_back(std::move(iterator->notification));
+
+			iterator->notification = Notification();
+		}
+
+		++iterator;
+	}
+
+	for (const Notification& notification : updates) {
+		emit NotificationUpdated(notification);
+	}
+
+	Schedule();
+}
+
+void NotificationThrottle::Schedule() {
+	qint64 next = -1;
+
+	for (const Entry& entry : m_entries) {
+		if (entry.pending && (next < 0 || entry.applied + m_interval < next)) {
+			next = entry.applied + m_interval;
+		}
+	}
+
+	if (next < 0) {
+		m_timer->stop();
+		return;
+	}
+
+	m_timer->start(static_cast<int>(std::max(next - m_clock.elapsed(), static_cast<qint64>(0))));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QHash>
+#include <QTimer>
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+
+#include "common.h"
+#include "batch.h"
+
+/*
+ * Rate limits updates of notifications that are already shown
+ *
+ * A notification key seen for the first time is posted right away.
+ * Updates to a known key are applied at most once per interval, only the
+ * latest payload received in the meantime is kept.
+ */
+
+class NotificationThrottle : public QObject {
+		Q_OBJECT
+
+	public:
+		NotificationThrottle(int interval, QObject* parent = nullptr);
+
+	public slots:
+		void NotificationReceived(const Notification& notification);
+		void NotificationRemoved(const Notification& notification);
+		void NotificationList(const Batch<Notification>& list);
+		void Clear();
+
+	signals:
+		void NotificationPosted(const Notification& notification);
+		void NotificationUpdated(const Notification& notification);
+
+	private slots:
+		void Flush();
+
+	private:
+		struct Entry {
+			qint64 applied;
+			bool pending;
+			Notification notification;
+		};
+
+		QHash<QString, Entry> m_entries;
+
+		QTimer* m_timer;
+		QElapsedTimer m_clock;
+
+		int m_interval;
+
+		void Schedule();
+};
@@ -63,12 +63,17 @@ OverlayController::OverlayController(QWidget* widget)
 	QTimer* renderTimer = new QTimer(this);
 
 	connect(renderTimer, &QTimer::timeout, this, [&]() {
+		/* Animations step at the overlay frame rate, their repaint is rendered next tick */
+		if (m_overlayVisible) {
+			emit RenderTick();
+		}
+
 		if (m_renderRequested) {
 			RenderOverlay();
 		}
 	});
 
-	renderTimer->setInterval(15);
+	renderTimer->setInterval(OVERLAY_RENDER_INTERVAL);
 	renderTimer->start();
 
 	QTimer* eventTimer = new QTimer(this);
@@ -122,7 +127,7 @@ bool OverlayController::InitOpenGL(std::string* error) {
 	return true;
 }
 
-bool OverlayController::ShowNotification(const std::string& identifier,
+bool OverlayController::ShowNotification(const InternedString& identifier,
 										 const std::string& text,
 										 bool sound,
 										 bool persistent) {
@@ -182,14 +187,14 @@ bool OverlayController::ShowNotification(const std::string& identifier,
 		m_notificationSound.play();
 	}
 
-	m_notifications.insert(std::pair<std::string, VRNotificationId>(
+	m_notifications.insert(std::pair<InternedString, VRNotificationId>(
 								   identifier,
 								   notificationId));
 
 	return true;
 }
 
-bool OverlayController::RemoveNotification(const std::string& identifier) {
+bool OverlayController::RemoveNotification(const InternedString& identifier) {
 	IVRNotifications* notifications = VRNotifications();
 
 	if (notifications == nullptr) {
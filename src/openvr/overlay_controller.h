@@ -14,6 +14,8 @@
 
 #include <openvr.h>
 
+#include "../interned_string.h"
+
 namespace OpenVR {
 	class OverlayController : public QObject {
 			Q_OBJECT
@@ -27,11 +29,11 @@ namespace OpenVR {
 			static void ShutdownVRRuntime();
 
 		public slots:
-			bool ShowNotification(const std::string& identifier,
+			bool ShowNotification(const InternedString& identifier,
 								  const std::string& text,
 								  bool sound = true,
 								  bool persistent = false);
-			bool RemoveNotification(const std::string& identifier);
+			bool RemoveNotification(const InternedString& identifier);
 			bool ShowKeyboard(uint8_t identifier,
 							  uint32_t maxLen,
 							  const char* initialText = nullptr,
@@ -48,7 +50,8 @@ namespace OpenVR {
 		signals:
 			void OverlayShown();
 			void OverlayHidden();
-			void NotificationOpened(const std::string& identifier);
+			void RenderTick();
+			void NotificationOpened(const InternedString& identifier);
 			void KeyboardData(uint8_t identifier, const std::string& data);
 
 		private:
@@ -70,7 +73,7 @@ namespace OpenVR {
 			QPointF m_lastPosition;
 			Qt::MouseButtons m_lastButtons;
 
-			std::map<std::string, vr::VRNotificationId> m_notifications;
+			std::map<InternedString, vr::VRNotificationId> m_notifications;
 			bool m_renderRequested;
 			bool m_overlayVisible;
 			bool m_keyboardVisible;
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <iterator>
+
+#include "search_index.h"
+
+SearchIndex::SearchIndex(int maxDocuments)
+	: m_firstId(0),
+	  m_maxDocuments(maxDocuments) {
+}
+
+void SearchIndex::AddNotification(const Notification& notification) {
+	Document document;
+	document.source = Source::NOTIFICATION;
+	document.date = QDateTime::currentDateTime();
+	document.origin = notification.appName.String();
+	document.title = notification.title;
+	document.text = notification.text;
+
+	Add(document);
+}
+
+void SearchIndex::AddSMS(const QString& number, const QString& name, const ShortSMS& shortSms) {
+	Document document;
+	document.source = Source::SMS;
+	document.date = shortSms.date;
+	document.origin = number;
+	document.title = name;
+	document.text = shortSms.body;
+
+	Add(document);
+}
+
+void SearchIndex::Add(const Document& document) {
+	/* Lists are received again on every refresh */
+	Entry entry;
+	entry.document = document;
+	entry.document.text = ellipsize(document.text, SEARCH_MAX_TEXT_LENGTH);
+	entry.fingerprint = Fingerprint(entry.document);
+
+	auto iterator = m_fingerprints.find(entry.fingerprint);
+
+	while (iterator != m_fingerprints.end() && iterator.key() == entry.fingerprint) {
+		if (IsSame(m_entries[iterator.value() - m_firstId].document, entry.document)) {
+			return;
+		}
+
+		++iterator;
+	}
+
+	quint32 id = m_firstId + static_cast<quint32>(m_entries.size());
+
+	for (const QString& token : Tokenize(entry.document)) {
+		m_postings[token].append(id);
+	}
+
+	m_fingerprints.insert(entry.fingerprint, id);
+	m_entries.push_back(std::move(entry));
+
+	while (static_cast<int>(m_entries.size()) > m_maxDocuments) {
+		Evict();
+	}
+}
+
+void SearchIndex::Restore(const std::vector<Document>& documents) {
+	Clear();
+
+	for (const Document& document : documents) {
+		Add(document);
+	}
+}
+
+void SearchIndex::Clear() {
+	m_entries.clear();
+	m_postings.clear();
+	m_fingerprints.clear();
+
+	m_firstId = 0;
+}
+
+std::vector<SearchIndex::Document> SearchIndex::Search(const QString& query, int limit) const {
+	std::vector<Document> results;
+
+	std::vector<QString> terms = Tokenize(query);
+
+	if (terms.empty()) {
+		return results;
+	}
+
+	std::vector<quint32> ids;
+	bool first = true;
+
+	for (const QString& term : terms) {
+		std::vector<quint32> matches;
+
+		auto iterator = m_postings.lowerBound(term);
+
+		while (iterator != m_postings.end() && iterator.key().startsWith(term)) {
+			matches.insert(matches.end(), iterator.value().begin(), iterator.value().end());
+
+			++iterator;
+		}
+
+		std::sort(matches.begin(), matches.end());
+		matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+		if (first) {
+			ids = std::move(matches);
+			first = false;
+		} else {
+			std::vector<quint32> intersection;
+
+			std::set_intersection(ids.begin(), ids.end(),
+								  matches.begin(), matches.end(),
+								  std::back_inserter(intersection));
+
+			ids = std::move(intersection);
+		}
+
+		if (ids.empty()) {
+			return results;
+		}
+	}
+
+	auto iterator = ids.rbegin();
+
+	while (iterator != ids.rend() && static_cast<int>(results.size()) < limit) {
+		results.push_back(m_entries[*iterator - m_firstId].document);
+
+		++iterator;
+	}
+
+	return results;
+}
+
+std::vector<SearchIndex::Document> SearchIndex::GetDocuments() const {
+	std::vector<Document> documents;
+	documents.reserve(m_entries.size());
+
+	for (const Entry& entry : m_entries) {
+		documents.push_back(entry.document);
+	}
+
+	return documents;
+}
+
+int SearchIndex::Size() const {
+	return static_cast<int>(m_entries.size());
+}
+
+void SearchIndex::Evict() {
+	const Entry& entry = m_entries.front();
+
+	/* Ids only grow, the oldest document is always first in its postings */
+	for (const QString& token : Tokenize(entry.document)) {
+		auto iterator = m_postings.find(token);
+
+		if (iterator == m_postings.end()) {
+			continue;
+		}
+
+		if (!iterator.value().isEmpty() && iterator.value().first() == m_firstId) {
+			iterator.value().removeFirst();
+		}
+
+		if (iterator.value().isEmpty()) {
+			m_postings.erase(iterator);
+		}
+	}
+
+	m_fingerprints.remove(entry.fingerprint, m_firstId);
+	m_entries.pop_front();
+
+	++m_firstId;
+}
+
+uint SearchIndex::Fingerprint(const Document& document) {
+	uint hash = qHash(static_cast<uint>(document.source));
+
+	hash ^= qHash(document.origin, hash);
+	hash ^= qHash(document.text, hash);
+
+	/* Sent SMS are indexed before the contact name is known */
+	if (document.source == Source::SMS) {
+		hash ^= qHash(document.date.toSecsSinceEpoch(), hash);
+	} else {
+		hash ^= qHash(document.title, hash);
+	}
+
+	return hash;
+}
+
+bool SearchIndex::IsSame(const Document& document, const Document& other) {
+	if (document.source != other.source
+			|| document.origin != other.origin
+			|| document.text != other.text) {
+		return false;
+	}
+
+	if (document.source == Source::SMS) {
+		return (document.date.toSecsSinceEpoch() == other.date.toSecsSinceEpoch());
+	}
+
+	return (document.title == other.title);
+}
+
+std::vector<QString> SearchIndex::Tokenize(const Document& document) {
+	return Tokenize(document.origin + " " + document.title + " " + document.text);
+}
+
+std::vector<QString> SearchIndex::Tokenize(const QString& text) {
+	std::vector<QString> tokens;
+
+	QString folded = text.toCaseFolded();
+	QString token;
+
+	for (int i = 0; i <= folded.length(); ++i) {
+		if (i < folded.length() && folded.at(i).isLetterOrNumber()) {
+			if (token.length() < SEARCH_MAX_TOKEN_LENGTH) {
+				token.append(folded.at(i));
+			}
+
+			continue;
+		}
+
+		if (!token.isEmpty()) {
+			tokens.push_back(token);
+			token.clear();
+		}
+	}
+
+	std::sort(tokens.begin(), tokens.end());
+	tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+	return tokens;
+}
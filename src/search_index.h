@@ -0,0 +1,73 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QDateTime>
+
+#include "common.h"
+
+/*
+ * Inverted index over the notifications and SMS seen by the bridge
+ *
+ * Tokens are case folded and kept sorted so every query term is matched
+ * as a prefix. Once the document limit is reached the oldest documents
+ * are dropped from the index.
+ */
+
+class SearchIndex {
+	public:
+		enum class Source : uint8_t {
+			NOTIFICATION = 0,
+			SMS
+		};
+
+		struct Document {
+			Source source;
+			QDateTime date;
+			QString origin;
+			QString title;
+			QString text;
+		};
+
+		SearchIndex(int maxDocuments);
+
+		void AddNotification(const Notification& notification);
+		void AddSMS(const QString& number, const QString& name, const ShortSMS& shortSms);
+		void Add(const Document& document);
+
+		void Restore(const std::vector<Document>& documents);
+		void Clear();
+
+		/* Newest first */
+		std::vector<Document> Search(const QString& query, int limit) const;
+		std::vector<Document> GetDocuments() const;
+
+		int Size() const;
+
+	private:
+		struct Entry {
+			Document document;
+			uint fingerprint;
+		};
+
+		std::deque<Entry> m_entries;
+		quint32 m_firstId;
+
+		QMap<QString, QVector<quint32>> m_postings;
+		/* Fingerprint to document id, the documents themselves are compared */
+		QMultiHash<uint, quint32> m_fingerprints;
+
+		int m_maxDocuments;
+
+		void Evict();
+
+		static uint Fingerprint(const Document& document);
+		static bool IsSame(const Document& document, const Document& other);
+		static std::vector<QString> Tokenize(const Document& document);
+		static std::vector<QString> Tokenize(const QString& text);
+};
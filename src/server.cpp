@@ -50,6 +50,10 @@ void Server::Stop() {
 			disconnect(client, &Client::HandshakePending, this, &Server::ClientHandshakePending);
 			disconnect(client, &Client::Disconnected, this, &Server::ClientDisconnected);
 			disconnect(client, &Client::MessageReceived, this, &Server::ClientMessageReceived);
+			disconnect(client,
+					   &Client::StreamedMessageReceived,
+					   this,
+					   &Server::ClientStreamedMessageReceived);
 
 			client->deleteLater();
 		}
@@ -109,6 +113,10 @@ void Server::NewConnection() {
 			connect(client, &Client::HandshakePending, this, &Server::ClientHandshakePending);
 			connect(client, &Client::Disconnected, this, &Server::ClientDisconnected);
 			connect(client, &Client::MessageReceived, this, &Server::ClientMessageReceived);
+			connect(client,
+					&Client::StreamedMessageReceived,
+					this,
+					&Server::ClientStreamedMessageReceived);
 
 			m_clients.append(client);
 		}
@@ -188,6 +196,10 @@ void Server::ClientDisconnected() {
 		disconnect(client, &Client::HandshakePending, this, &Server::ClientHandshakePending);
 		disconnect(client, &Client::Disconnected, this, &Server::ClientDisconnected);
 		disconnect(client, &Client::MessageReceived, this, &Server::ClientMessageReceived);
+		disconnect(client,
+				   &Client::StreamedMessageReceived,
+				   this,
+				   &Server::ClientStreamedMessageReceived);
 
 		m_clients.removeOne(client);
 
@@ -208,3 +220,11 @@ void Server::ClientMessageReceived(const QString& type, const QJsonObject& json)
 		emit MessageReceived(type, json);
 	}
 }
+
+void Server::ClientStreamedMessageReceived(const StreamedMessage& message) {
+	QPointer<Client> client(qobject_cast<Client*>(sender()));
+
+	if (client != nullptr && client == m_client) {
+		emit StreamedMessageReceived(message);
+	}
+}
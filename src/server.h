@@ -37,10 +37,12 @@ class Server : public QObject {
 		void ClientHandshakePending();
 		void ClientDisconnected();
 		void ClientMessageReceived(const QString& type, const QJsonObject& json);
+		void ClientStreamedMessageReceived(const StreamedMessage& message);
 
 	signals:
 		void ConnectedChange(bool connected);
 		void MessageReceived(const QString& type, const QJsonObject& json);
+		void StreamedMessageReceived(const StreamedMessage& message);
 
 	private:
 		QString m_publicKey;
@@ -0,0 +1,165 @@
+#include "sms_cache.h"
+
+SMSCache::SMSCache(int budget)
+	: m_budget(budget),
+	  m_size(0) {
+}
+
+bool SMSCache::Find(const QString& number, int page, QString* name, Batch<ShortSMS>* list) {
+	auto iterator = m_index.find(Key(number, page));
+
+	if (iterator == m_index.end()) {
+		return false;
+	}
+
+	m_pages.splice(m_pages.begin(), m_pages, iterator.value());
+
+	*name = iterator.value()->name;
+	*list = iterator.value()->list.Share();
+
+	return true;
+}
+
+bool SMSCache::Contains(const QString& number, int page) const {
+	return m_index.contains(Key(number, page));
+}
+
+void SMSCache::Insert(const QString& number,
+					  const QString& name,
+					  int page,
+					  const Batch<ShortSMS>& list) {
+	Key key(number, page);
+
+	if (page == 0) {
+		/* Older pages only line up with the page 0 they were loaded after */
+		auto iterator = m_index.find(key);
+
+		if (iterator != m_index.end()) {
+			const Batch<ShortSMS>& cached = iterator.value()->list;
+
+			if (cached.IsEmpty() || list.IsEmpty() || cached.At(0).date != list.At(0).date) {
+				Invalidate(number);
+			}
+		}
+	}
+
+	Page entry;
+	entry.key = key;
+	entry.name = name;
+	entry.list = list.Share();
+
+	Store(std::move(entry));
+}
+
+void SMSCache::Prepend(const QString& number, const ShortSMS& shortSms) {
+	auto iterator = m_index.find(Key(number, 0));
+
+	if (iterator == m_index.end()) {
+		return;
+	}
+
+	std::list<Page>::iterator page = iterator.value();
+
+	/* Only detaches if the page is still shared with a view */
+	page->list.Prepend(shortSms);
+
+	page->size += ItemSize(shortSms);
+	m_size += ItemSize(shortSms);
+
+	m_pages.splice(m_pages.begin(), m_pages, page);
+
+	/* Later pages are shifted by one */
+	Invalidate(number, 1);
+
+	Evict();
+}
+
+void SMSCache::Invalidate(const QString& number, int firstPage) {
+	auto iterator = m_pages.begin();
+
+	while (iterator != m_pages.end()) {
+		if (iterator->key.first == number && iterator->key.second >= firstPage) {
+			m_size -= iterator->size;
+			m_index.remove(iterator->key);
+
+			iterator = m_pages.erase(iterator);
+		} else {
+			++iterator;
+		}
+	}
+}
+
+void SMSCache::Clear() {
+	m_pages.clear();
+	m_index.clear();
+
+	m_size = 0;
+}
+
+std::vector<SMSCache::Thread> SMSCache::GetThreads(int count) const {
+	std::vector<Thread> threads;
+
+	auto iterator = m_pages.begin();
+
+	while (iterator != m_pages.end() && static_cast<int>(threads.size()) < count) {
+		if (iterator->key.second == 0) {
+			Thread thread;
+			thread.number = iterator->key.first;
+			thread.name = iterator->name;
+			thread.list = iterator->list.Share();
+
+			threads.push_back(std::move(thread));
+		}
+
+		++iterator;
+	}
+
+	return threads;
+}
+
+void SMSCache::Store(Page&& page) {
+	Erase(page.key);
+
+	page.size = PageSize(page);
+
+	m_size += page.size;
+
+	m_pages.push_front(std::move(page));
+	m_index.insert(m_pages.front().key, m_pages.begin());
+
+	Evict();
+}
+
+void SMSCache::Erase(const Key& key) {
+	auto iterator = m_index.find(key);
+
+	if (iterator == m_index.end()) {
+		return;
+	}
+
+	m_size -= iterator.value()->size;
+
+	m_pages.erase(iterator.value());
+	m_index.erase(iterator);
+}
+
+void SMSCache::Evict() {
+	while (m_size > m_budget && m_pages.size() > 1) {
+		Erase(m_pages.back().key);
+	}
+}
+
+int SMSCache::PageSize(const Page& page) {
+	int size = static_cast<int>(sizeof(Page))
+			   + (page.key.first.size() + page.name.size()) * static_cast<int>(sizeof(QChar));
+
+	for (const ShortSMS& shortSms : page.list) {
+		size += ItemSize(shortSms);
+	}
+
+	return size;
+}
+
+int SMSCache::ItemSize(const ShortSMS& shortSms) {
+	return static_cast<int>(sizeof(ShortSMS)) + shortSms.body.size() * static_cast<int>(sizeof(QChar));
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <list>
+#include <vector>
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+#include "common.h"
+#include "batch.h"
+
+/*
+ * Least recently used cache of SMS thread pages, keyed by (number, page)
+ *
+ * Pages are dropped, least recently used first, once their estimated
+ * size goes over the budget.
+ */
+
+class SMSCache {
+	public:
+		struct Thread {
+			QString number;
+			QString name;
+			Batch<ShortSMS> list;
+		};
+
+		SMSCache(int budget);
+
+		bool Find(const QString& number, int page, QString* name, Batch<ShortSMS>* list);
+		bool Contains(const QString& number, int page) const;
+
+		void Insert(const QString& number,
+					const QString& name,
+					int page,
+					const Batch<ShortSMS>& list);
+		void Prepend(const QString& number, const ShortSMS& shortSms);
+
+		void Invalidate(const QString& number, int firstPage = 0);
+		void Clear();
+
+		std::vector<Thread> GetThreads(int count) const;
+
+	private:
+		typedef QPair<QString, int> Key;
+
+		struct Page {
+			Key key;
+			QString name;
+			Batch<ShortSMS> list;
+			int size;
+		};
+
+		/* Most recently used first */
+		std::list<Page> m_pages;
+		QHash<Key, std::list<Page>::iterator> m_index;
+
+		int m_budget;
+		int m_size;
+
+		void Store(Page&& page);
+		void Erase(const Key& key);
+		void Evict();
+
+		static int PageSize(const Page& page);
+		static int ItemSize(const ShortSMS& shortSms);
+};
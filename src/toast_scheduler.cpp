@@ -0,0 +1,148 @@
+#include <algorithm>
+
+#include "toast_scheduler.h"
+
+#define TOAST_APP_PREFIX    "app:"
+
+ToastScheduler::ToastScheduler(QObject* parent)
+	: QObject(parent),
+	  m_timer(nullptr),
+	  m_window(TOAST_COALESCE_WINDOW),
+	  m_lastSound(-TOAST_SOUND_INTERVAL) {
+	m_timer = new QTimer(this);
+
+	connect(m_timer, &QTimer::timeout, this, &ToastScheduler::Flush);
+
+	m_timer->setSingleShot(true);
+
+	m_clock.start();
+}
+
+void ToastScheduler::SetWindow(int window) {
+	m_window = std::max(window, 0);
+}
+
+void ToastScheduler::NotificationReceived(const Notification& notification, bool sound) {
+	qint64 now = m_clock.elapsed();
+
+	auto iterator = m_bursts.find(notification.appName);
+
+	if (iterator == m_bursts.end()) {
+		Burst burst;
+		burst.identifier = InternedString(TOAST_APP_PREFIX + notification.appName.String());
+		burst.windowEnd = 0;
+		burst.sound = false;
+
+		iterator = m_bursts.insert(notification.appName, burst);
+	}
+
+	Burst& burst = iterator.value();
+
+	burst.keys.insert(notification.key);
+
+	if (burst.pending.empty() && now >= burst.windowEnd) {
+		/* Quiet app, shown right away */
+		burst.sound = sound;
+
+		Show(&burst, notification.appName.String() + "\n" + notification.title);
+		return;
+	}
+
+	burst.pending.push_back(notification);
+	burst.sound = (burst.sound || sound);
+
+	Schedule();
+}
+
+void ToastScheduler::NotificationRemoved(const Notification& notification) {
+	auto iterator = m_bursts.find(notification.appName);
+
+	if (iterator == m_bursts.end() || !iterator->keys.remove(notification.key)) {
+		return;
+	}
+
+	Burst& burst = iterator.value();
+
+	auto pending = std::find_if(burst.pending.begin(),
+								burst.pending.end(),
+	[&](const Notification & item) {
+		return (item.key == notification.key);
+	});
+
+	/* Gone before its summary, no longer counted in it */
+	if (pending != burst.pending.end()) {
+		burst.pending.erase(pending);
+	}
+
+	if (burst.keys.isEmpty()) {
+		emit RemoveToast(burst.identifier);
+
+		m_bursts.erase(iterator);
+	}
+
+	Schedule();
+}
+
+void ToastScheduler::Clear() {
+	m_timer->stop();
+
+	m_bursts.clear();
+}
+
+void ToastScheduler::Flush() {
+	qint64 now = m_clock.elapsed();
+
+	auto iterator = m_bursts.begin();
+
+	while (iterator != m_bursts.end()) {
+		Burst& burst = iterator.value();
+
+		if (!burst.pending.empty() && now >= burst.windowEnd) {
+			Show(&burst,
+				 QString("%1 new from %2\n%3").arg(static_cast<int>(burst.pending.size()))
+				 .arg(iterator.key().String(), burst.pending.back().title));
+		}
+
+		++iterator;
+	}
+
+	Schedule();
+}
+
+void ToastScheduler::Show(Burst* burst, const QString& text) {
+	emit ShowToast(burst->identifier, text.toStdString(), (burst->sound && SoundAllowed()));
+
+	/* Anything else within the window waits for the next summary */
+	burst->windowEnd = m_clock.elapsed() + m_window;
+	burst->pending.clear();
+	burst->sound = false;
+}
+
+void ToastScheduler::Schedule() {
+	qint64 next = -1;
+
+	for (const Burst& burst : m_bursts) {
+		if (!burst.pending.empty() && (next < 0 || burst.windowEnd < next)) {
+			next = burst.windowEnd;
+		}
+	}
+
+	if (next < 0) {
+		m_timer->stop();
+		return;
+	}
+
+	m_timer->start(static_cast<int>(std::max(next - m_clock.elapsed(), static_cast<qint64>(0))));
+}
+
+bool ToastScheduler::SoundAllowed() {
+	qint64 now = m_clock.elapsed();
+
+	if (now - m_lastSound < TOAST_SOUND_INTERVAL) {
+		return false;
+	}
+
+	m_lastSound = now;
+
+	return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QSet>
+#include <QHash>
+#include <QTimer>
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+
+#include "common.h"
+
+/*
+ * Coalesces phone notifications into VR toasts
+ *
+ * The first notification of an app is shown right away, the ones that
+ * follow within the window are merged into a single summary toast for
+ * that app. Every app has one toast that is replaced rather than stacked,
+ * and the sound is played at most once per sound interval.
+ */
+
+class ToastScheduler : public QObject {
+		Q_OBJECT
+
+	public:
+		ToastScheduler(QObject* parent = nullptr);
+
+		void SetWindow(int window);
+
+	public slots:
+		void NotificationReceived(const Notification& notification, bool sound);
+		void NotificationRemoved(const Notification& notification);
+		void Clear();
+
+	signals:
+		void ShowToast(const InternedString& identifier,
+					   const std::string& text,
+					   bool sound = true,
+					   bool persistent = false);
+		void RemoveToast(const InternedString& identifier);
+
+	private slots:
+		void Flush();
+
+	private:
+		struct Burst {
+			InternedString identifier;
+			qint64 windowEnd;
+			bool sound;
+			/* Shown or waiting, the toast goes away with the last one */
+			QSet<QString> keys;
+			/* Waiting for the summary, oldest first */
+			std::vector<Notification> pending;
+		};
+
+		QHash<InternedString, Burst> m_bursts;
+
+		QTimer* m_timer;
+		QElapsedTimer m_clock;
+
+		int m_window;
+		qint64 m_lastSound;
+
+		void Show(Burst* burst, const QString& text);
+		void Schedule();
+		bool SoundAllowed();
+};
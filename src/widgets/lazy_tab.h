@@ -0,0 +1,44 @@
+#pragma once
+
+#include <functional>
+
+/*
+ * Tab widget built the first time it is needed
+ *
+ * Nothing is queued for a tab that does not exist yet, a newly built tab
+ * is brought up to date by its factory and loads its content itself.
+ * Peek() never builds the widget.
+ */
+
+template<typename T>
+class LazyTab {
+	public:
+		typedef std::function<T*()> Factory;
+
+		LazyTab()
+			: m_widget(nullptr) {
+		}
+
+		LazyTab(const LazyTab&) = delete;
+		LazyTab& operator=(const LazyTab&) = delete;
+
+		void SetFactory(const Factory& factory) {
+			m_factory = factory;
+		}
+
+		T* Get() {
+			if (m_widget == nullptr && m_factory) {
+				m_widget = m_factory();
+			}
+
+			return m_widget;
+		}
+
+		T* Peek() const {
+			return m_widget;
+		}
+
+	private:
+		Factory m_factory;
+		T* m_widget;
+};
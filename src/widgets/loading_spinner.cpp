@@ -0,0 +1,193 @@
+#include <QPainter>
+#include <QSvgRenderer>
+
+#include "loading_spinner.h"
+
+#define SPINNER_PATH        ":/images/loading.svg"
+#define SPINNER_FRAMES      30
+#define SPINNER_PERIOD      1000
+
+static SpinnerSheet* sheetInstance = nullptr;
+
+SpinnerSheet::SpinnerSheet(int size, QObject* parent)
+	: QObject(parent),
+	  m_timer(nullptr),
+	  m_size(size),
+	  m_frame(0),
+	  m_shown(0),
+	  m_useTimer(true) {
+	QPixmap image(m_size, m_size);
+	image.fill(Qt::transparent);
+
+	QSvgRenderer renderer(QString(SPINNER_PATH));
+
+	QPainter imagePainter(&image);
+	renderer.render(&imagePainter);
+	imagePainter.end();
+
+	m_sheet = QPixmap(m_size * SPINNER_FRAMES, m_size);
+	m_sheet.fill(Qt::transparent);
+
+	QPainter painter(&m_sheet);
+	painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+	/* The indicator is a rotating arc, every frame is the first one rotated */
+	for (int i = 0; i < SPINNER_FRAMES; ++i) {
+		painter.save();
+
+		painter.translate(i * m_size + m_size / 2.0, m_size / 2.0);
+		painter.rotate(360.0 * i / SPINNER_FRAMES);
+		painter.translate(-m_size / 2.0, -m_size / 2.0);
+
+		painter.drawPixmap(0, 0, image);
+
+		painter.restore();
+	}
+
+	painter.end();
+
+	m_timer = new QTimer(this);
+
+	connect(m_timer, &QTimer::timeout, this, &SpinnerSheet::Tick);
+
+	m_timer->setInterval(SPINNER_PERIOD / SPINNER_FRAMES);
+	m_timer->setTimerType(Qt::PreciseTimer);
+
+	m_clock.start();
+
+	sheetInstance = this;
+}
+
+SpinnerSheet::~SpinnerSheet() {
+	if (sheetInstance == this) {
+		sheetInstance = nullptr;
+	}
+}
+
+SpinnerSheet* SpinnerSheet::Get() {
+	return sheetInstance;
+}
+
+const QPixmap& SpinnerSheet::Pixmap() const {
+	return m_sheet;
+}
+
+int SpinnerSheet::Size() const {
+	return m_size;
+}
+
+int SpinnerSheet::Frame() const {
+	return m_frame;
+}
+
+void SpinnerSheet::UseTimer(bool enabled) {
+	m_useTimer = enabled;
+
+	UpdateTimer();
+}
+
+void SpinnerSheet::Attach() {
+	if (m_shown++ == 0) {
+		m_frame = CurrentFrame();
+	}
+
+	UpdateTimer();
+}
+
+void SpinnerSheet::Detach() {
+	if (m_shown > 0) {
+		--m_shown;
+	}
+
+	UpdateTimer();
+}
+
+void SpinnerSheet::Tick() {
+	if (m_shown == 0) {
+		return;
+	}
+
+	int frame = CurrentFrame();
+
+	/* A late tick skips frames rather than slowing the rotation down */
+	if (frame != m_frame) {
+		m_frame = frame;
+
+		emit FrameChanged();
+	}
+}
+
+int SpinnerSheet::CurrentFrame() const {
+	return static_cast<int>((m_clock.elapsed() % SPINNER_PERIOD) * SPINNER_FRAMES / SPINNER_PERIOD);
+}
+
+void SpinnerSheet::UpdateTimer() {
+	if (m_useTimer && m_shown > 0) {
+		if (!m_timer->isActive()) {
+			m_timer->start();
+		}
+	} else {
+		m_timer->stop();
+	}
+}
+
+LoadingSpinner::LoadingSpinner(int size, QWidget* parent)
+	: QWidget(parent),
+	  m_sheet(SpinnerSheet::Get()),
+	  m_size(size) {
+	setFixedSize(size, size);
+}
+
+LoadingSpinner::~LoadingSpinner() {
+	/* Tabs can be destroyed while their spinner is shown */
+	if (m_sheet != nullptr && m_connection) {
+		disconnect(m_connection);
+
+		m_sheet->Detach();
+	}
+}
+
+void LoadingSpinner::paintEvent(QPaintEvent*) {
+	if (m_sheet == nullptr) {
+		return;
+	}
+
+	QPainter painter(this);
+
+	int sheetSize = m_sheet->Size();
+
+	if (sheetSize != m_size) {
+		painter.setRenderHint(QPainter::SmoothPixmapTransform);
+	}
+
+	painter.drawPixmap(QRect(0, 0, m_size, m_size),
+					   m_sheet->Pixmap(),
+					   QRect(m_sheet->Frame() * sheetSize, 0, sheetSize, sheetSize));
+}
+
+void LoadingSpinner::showEvent(QShowEvent* e) {
+	QWidget::showEvent(e);
+
+	if (m_sheet == nullptr || m_connection) {
+		return;
+	}
+
+	m_connection = connect(m_sheet, &SpinnerSheet::FrameChanged, this, [&]() {
+		update();
+	});
+
+	m_sheet->Attach();
+}
+
+void LoadingSpinner::hideEvent(QHideEvent* e) {
+	QWidget::hideEvent(e);
+
+	if (m_sheet == nullptr || !m_connection) {
+		return;
+	}
+
+	disconnect(m_connection);
+	m_connection = QMetaObject::Connection();
+
+	m_sheet->Detach();
+}
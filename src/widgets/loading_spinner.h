@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QPixmap>
+#include <QWidget>
+#include <QElapsedTimer>
+
+/*
+ * Sprite sheet and frame clock shared by every spinner
+ *
+ * Created by the application before any widget and destroyed before it,
+ * the sheet is rendered once in the constructor. Frames are advanced by
+ * Tick(), connected to the overlay render loop. Without an overlay, an
+ * internal timer ticks at the frame rate while a spinner is shown.
+ */
+
+class SpinnerSheet : public QObject {
+		Q_OBJECT
+
+	public:
+		SpinnerSheet(int size, QObject* parent = nullptr);
+		~SpinnerSheet();
+
+		static SpinnerSheet* Get();
+
+		const QPixmap& Pixmap() const;
+		int Size() const;
+		int Frame() const;
+
+		void UseTimer(bool enabled);
+
+		void Attach();
+		void Detach();
+
+	public slots:
+		void Tick();
+
+	signals:
+		void FrameChanged();
+
+	private:
+		QPixmap m_sheet;
+		QTimer* m_timer;
+		QElapsedTimer m_clock;
+
+		int m_size;
+		int m_frame;
+		int m_shown;
+		bool m_useTimer;
+
+		int CurrentFrame() const;
+		void UpdateTimer();
+};
+
+/*
+ * Loading indicator blitting frames from the shared sprite sheet
+ *
+ * Only the spinner is repainted, and only while it is shown.
+ */
+
+class LoadingSpinner : public QWidget {
+		Q_OBJECT
+
+	public:
+		LoadingSpinner(int size, QWidget* parent = nullptr);
+		~LoadingSpinner();
+
+	protected:
+		void paintEvent(QPaintEvent* e) override;
+		void showEvent(QShowEvent* e) override;
+		void hideEvent(QHideEvent* e) override;
+
+	private:
+		SpinnerSheet* m_sheet;
+		QMetaObject::Connection m_connection;
+
+		int m_size;
+};
@@ -1,6 +1,9 @@
+#include <algorithm>
+
 #include <QDir>
 #include <QFile>
 #include <QStyle>
+#include <QStandardPaths>
 #include <QGraphicsOpacityEffect>
 
 #include <spdlog/spdlog.h>
@@ -14,25 +17,48 @@ MainWidget::MainWidget(QSettings* settings, QWidget* parent)
 	  ui(new Ui::MainWidget),
 	  m_currentTab(Tab::NONE),
 	  m_serverState(ServerState::NONE),
+	  m_graceTimer(nullptr),
+	  m_clientIdentifier(QString()),
+	  m_store(nullptr),
+	  m_storeTimer(nullptr),
+	  m_contentRestored(false),
+	  m_history(nullptr),
+	  m_searchIndex(SEARCH_MAX_DOCUMENTS),
+	  m_searchIdentifier(QString()),
 	  m_settings(settings),
 	  m_bridge(nullptr),
+	  m_toastScheduler(nullptr),
+	  m_notificationThrottle(nullptr),
 	  m_server(nullptr),
-	  m_notificationsTab(nullptr),
-	  m_smsTab(nullptr),
-	  m_deviceTab(nullptr),
-	  m_settingsTab(nullptr) {
+	  m_overlayVisible(true) {
 	ui->setupUi(this);
 
 	ui->appNameLabel->setText(OVERLAY_NAME);
 	ui->versionLabel->setText(APP_VERSION);
 
+	m_graceTimer = new QTimer(this);
+
+	connect(m_graceTimer, &QTimer::timeout, this, &MainWidget::GracePeriodExpired);
+
+	m_graceTimer->setInterval(RECONNECT_GRACE_PERIOD);
+	m_graceTimer->setSingleShot(true);
+
 	SetupStylesheet();
+	SetupKeys();
+	SetupStore();
 	SetupBridge();
 	SetupTabs();
+
+	RestoreContent();
+
 	SetupServer();
 }
 
 MainWidget::~MainWidget() {
+	m_storeTimer->stop();
+
+	SaveContent();
+
 	m_serverState = ServerState::STOPPED;
 
 	StopServer();
@@ -41,26 +67,44 @@ MainWidget::~MainWidget() {
 }
 
 void MainWidget::VROverlayShown() {
+	m_overlayVisible = true;
+
+	if (m_notificationsTab.Peek() != nullptr) {
+		m_notificationsTab.Peek()->OverlayVisibilityChanged(true);
+	}
+
 	SwitchTab(m_serverState == ServerState::CONNECTED
 			  ? Tab::NOTIFICATIONS
 			  : Tab::SETTINGS, false);
 }
 
-void MainWidget::VRNotificationOpened(const std::string& identifier) {
+void MainWidget::VROverlayHidden() {
+	m_overlayVisible = false;
+
+	if (m_notificationsTab.Peek() != nullptr) {
+		m_notificationsTab.Peek()->OverlayVisibilityChanged(false);
+	}
+}
+
+void MainWidget::VRNotificationOpened(const InternedString& identifier) {
 	if (m_serverState == ServerState::CONNECTED) {
-		if (identifier.rfind("notif_", 0) == 0) {
+		if (!identifier.String().startsWith(SYSTEM_NOTIFICATION_PREFIX)) {
 			SwitchTab(Tab::NOTIFICATIONS, false);
 		}
 	}
 }
 
 void MainWidget::VRKeyboardData(uint8_t identifier, const std::string& data) {
-	if (m_smsTab != nullptr) {
-		m_smsTab->VRKeyboardData(identifier, data);
+	if (m_notificationsTab.Peek() != nullptr) {
+		m_notificationsTab.Peek()->VRKeyboardData(identifier, data);
+	}
+
+	if (m_smsTab.Peek() != nullptr) {
+		m_smsTab.Peek()->VRKeyboardData(identifier, data);
 	}
 
-	if (m_settingsTab != nullptr) {
-		m_settingsTab->VRKeyboardData(identifier, data);
+	if (m_settingsTab.Peek() != nullptr) {
+		m_settingsTab.Peek()->VRKeyboardData(identifier, data);
 	}
 }
 
@@ -72,6 +116,41 @@ void MainWidget::ServerStateChanged(bool connected) {
 	}
 }
 
+void MainWidget::GracePeriodExpired() {
+	if (m_serverState != ServerState::CONNECTED) {
+		ExpireContent();
+	}
+}
+
+void MainWidget::SaveContent() {
+	if (m_store.isNull() || m_clientIdentifier.isEmpty()) {
+		return;
+	}
+
+	MessageStore::Content content;
+
+	content.clientIdentifier = m_clientIdentifier;
+
+	m_bridge->GetNotifications(&content.notifications);
+
+	if (m_smsTab.Peek() != nullptr) {
+		content.smsList = m_smsTab.Peek()->GetSMSList().Share();
+		content.threads = m_smsTab.Peek()->GetThreads(STORE_MAX_THREADS);
+	} else {
+		content.smsList = m_restoredSMSList.Share();
+		content.threads = m_restoredThreads;
+	}
+
+	content.searchIdentifier = m_searchIdentifier;
+	content.documents = m_searchIndex.GetDocuments();
+
+	std::string error;
+
+	if (!m_store->Save(content, &error)) {
+		spdlog::warn(error);
+	}
+}
+
 void MainWidget::on_notificationsButton_clicked() {
 	SwitchTab(Tab::NOTIFICATIONS);
 }
@@ -91,16 +170,16 @@ void MainWidget::on_settingsButton_clicked() {
 QWidget* MainWidget::GetTabWidget(const Tab& tab) {
 	switch (tab) {
 		case Tab::NOTIFICATIONS:
-			return m_notificationsTab;
+			return m_notificationsTab.Get();
 
 		case Tab::SMS:
-			return m_smsTab;
+			return m_smsTab.Get();
 
 		case Tab::DEVICE:
-			return m_deviceTab;
+			return m_deviceTab.Get();
 
 		case Tab::SETTINGS:
-			return m_settingsTab;
+			return m_settingsTab.Get();
 
 		default:
 			return nullptr;
@@ -112,101 +191,71 @@ void MainWidget::SwitchTab(const Tab& tab, bool animate) {
 		return;
 	}
 
-	switch (tab) {
-		case Tab::NOTIFICATIONS:
-			ui->smsButton->SetHighlight(false);
-			ui->deviceButton->SetHighlight(false);
-			ui->settingsButton->SetHighlight(false);
-			ui->notificationsButton->SetHighlight(true);
-
-			if (animate) {
-				FadeOutIn(GetTabWidget(m_currentTab), m_notificationsTab, 50, 100);
-			} else {
-				m_smsTab->setVisible(false);
-				m_deviceTab->setVisible(false);
-				m_settingsTab->setVisible(false);
-				m_notificationsTab->setVisible(true);
-			}
-
-			ui->identifierLabel->setVisible(false);
+	QWidget* widget = GetTabWidget(tab);
 
-			break;
-
-		case Tab::SMS:
-			ui->notificationsButton->SetHighlight(false);
-			ui->deviceButton->SetHighlight(false);
-			ui->settingsButton->SetHighlight(false);
-			ui->smsButton->SetHighlight(true);
-
-			if (animate) {
-				FadeOutIn(GetTabWidget(m_currentTab), m_smsTab, 50, 100);
-			} else {
-				m_notificationsTab->setVisible(false);
-				m_deviceTab->setVisible(false);
-				m_settingsTab->setVisible(false);
-				m_smsTab->setVisible(true);
-			}
-
-			ui->identifierLabel->setVisible(false);
-
-			break;
-
-		case Tab::DEVICE:
-			ui->notificationsButton->SetHighlight(false);
-			ui->smsButton->SetHighlight(false);
-			ui->settingsButton->SetHighlight(false);
-			ui->deviceButton->SetHighlight(true);
-
-			if (animate) {
-				FadeOutIn(GetTabWidget(m_currentTab), m_deviceTab, 50, 100);
-			} else {
-				m_notificationsTab->setVisible(false);
-				m_smsTab->setVisible(false);
-				m_settingsTab->setVisible(false);
-				m_deviceTab->setVisible(true);
-			}
+	if (widget == nullptr) {
+		return;
+	}
 
-			ui->identifierLabel->setVisible(false);
+	ui->notificationsButton->SetHighlight(tab == Tab::NOTIFICATIONS);
+	ui->smsButton->SetHighlight(tab == Tab::SMS);
+	ui->deviceButton->SetHighlight(tab == Tab::DEVICE);
+	ui->settingsButton->SetHighlight(tab == Tab::SETTINGS);
+
+	if (tab == Tab::SETTINGS) {
+		if (animate) {
+			FadeOutIn(GetTabWidget(m_currentTab),
+					  widget,
+					  50,
+					  100,
+					  QEasingCurve::Linear,
+					  QEasingCurve::Linear,
+			[&](bool aborted) {
+				if (!aborted) {
+					ui->identifierLabel->setVisible(true);
+				}
+			});
+		} else {
+			ShowTab(widget);
+
+			ui->identifierLabel->setVisible(true);
+		}
+	} else {
+		if (animate) {
+			FadeOutIn(GetTabWidget(m_currentTab), widget, 50, 100);
+		} else {
+			ShowTab(widget);
+		}
 
-			break;
+		ui->identifierLabel->setVisible(false);
+	}
 
-		case Tab::SETTINGS:
-			ui->notificationsButton->SetHighlight(false);
-			ui->smsButton->SetHighlight(false);
-			ui->deviceButton->SetHighlight(false);
-			ui->settingsButton->SetHighlight(true);
-
-			if (animate) {
-				FadeOutIn(GetTabWidget(m_currentTab),
-						  m_settingsTab,
-						  50,
-						  100,
-						  QEasingCurve::Linear,
-						  QEasingCurve::Linear,
-				[&](bool aborted) {
-					if (!aborted) {
-						ui->identifierLabel->setVisible(true);
-					}
-				});
-			} else {
-				m_notificationsTab->setVisible(false);
-				m_smsTab->setVisible(false);
-				m_deviceTab->setVisible(false);
-				m_settingsTab->setVisible(true);
-
-				ui->identifierLabel->setVisible(true);
-			}
+	m_currentTab = tab;
 
-			break;
+	if (m_notificationsTab.Peek() != nullptr) {
+		m_notificationsTab.Peek()->CurrentTabChanged(m_currentTab);
+	}
 
-		default:
-			return;
+	if (m_smsTab.Peek() != nullptr) {
+		m_smsTab.Peek()->CurrentTabChanged(m_currentTab);
 	}
+}
 
-	m_currentTab = tab;
+void MainWidget::ShowTab(QWidget* widget) {
+	QWidget* tabs[] = {
+		m_notificationsTab.Peek(),
+		m_smsTab.Peek(),
+		m_deviceTab.Peek(),
+		m_settingsTab.Peek()
+	};
+
+	for (QWidget* tab : tabs) {
+		if (tab != nullptr && tab != widget) {
+			tab->setVisible(false);
+		}
+	}
 
-	m_notificationsTab->CurrentTabChanged(m_currentTab);
-	m_smsTab->CurrentTabChanged(m_currentTab);
+	widget->setVisible(true);
 }
 
 void MainWidget::UpdateServerState(const ServerState& state) {
@@ -216,27 +265,49 @@ void MainWidget::UpdateServerState(const ServerState& state) {
 
 	switch (state) {
 		case ServerState::STOPPED:
+			ExpireContent();
+
 			ui->statusLabel->setText("<font color='#8a2929'>Stopped</font>");
 			break;
 
 		case ServerState::STARTED:
+			if (m_serverState == ServerState::CONNECTED) {
+				m_graceTimer->start();
+			}
+
 			ui->statusLabel->setText("Running");
 			break;
 
 		case ServerState::CONNECTED:
-			m_deviceTab->SetDeviceName(m_server->GetClient()->GetDeviceName());
-			m_deviceTab->SetIdentifier(m_server->GetClient()->GetIdentifier());
-			m_deviceTab->SetAddress(m_server->GetClient()->GetAddressString());
-			m_deviceTab->SetAppVersion(m_server->GetClient()->GetAppVersion());
-			m_deviceTab->SetOS(m_server->GetClient()->GetOSType(),
-							   m_server->GetClient()->GetOSVersion());
+			if ((!m_graceTimer->isActive() && !m_contentRestored)
+					|| m_clientIdentifier != m_server->GetClient()->GetIdentifier()) {
+				ExpireContent();
+			}
 
-			m_deviceTab->SetFeatures(m_server->GetClient()->HasNotifications(),
-									 m_server->GetClient()->HasSMS());
+			m_graceTimer->stop();
 
-			m_notificationsTab->SetFeatureEnabled(m_server->GetClient()->HasNotifications());
+			/* Kept across disconnections, only another phone drops it */
+			if (m_searchIdentifier != m_server->GetClient()->GetIdentifier()) {
+				m_searchIndex.Clear();
 
-			m_smsTab->SetFeatureEnabled(m_server->GetClient()->HasSMS());
+				m_searchIdentifier = m_server->GetClient()->GetIdentifier();
+			}
+
+			m_contentRestored = false;
+
+			m_clientIdentifier = m_server->GetClient()->GetIdentifier();
+
+			if (m_deviceTab.Peek() != nullptr) {
+				UpdateDeviceTab(m_deviceTab.Peek());
+			}
+
+			if (m_notificationsTab.Peek() != nullptr) {
+				m_notificationsTab.Peek()->SetFeatureEnabled(m_server->GetClient()->HasNotifications());
+			}
+
+			if (m_smsTab.Peek() != nullptr) {
+				m_smsTab.Peek()->SetFeatureEnabled(m_server->GetClient()->HasSMS());
+			}
 
 			ui->statusLabel->setText("<font color='#52a93e'>Connected</font>");
 			break;
@@ -247,10 +318,97 @@ void MainWidget::UpdateServerState(const ServerState& state) {
 
 	m_serverState = state;
 
-	m_notificationsTab->ServerStateChanged(m_serverState);
-	m_smsTab->ServerStateChanged(m_serverState);
-	m_deviceTab->ServerStateChanged(m_serverState);
-	m_settingsTab->ServerStateChanged(m_serverState);
+	if (m_notificationsTab.Peek() != nullptr) {
+		m_notificationsTab.Peek()->ServerStateChanged(m_serverState);
+	}
+
+	if (m_smsTab.Peek() != nullptr) {
+		m_smsTab.Peek()->ServerStateChanged(m_serverState);
+	}
+
+	if (m_deviceTab.Peek() != nullptr) {
+		m_deviceTab.Peek()->ServerStateChanged(m_serverState);
+	}
+
+	if (m_settingsTab.Peek() != nullptr) {
+		m_settingsTab.Peek()->ServerStateChanged(m_serverState);
+	}
+}
+
+void MainWidget::UpdateDeviceTab(DeviceTabWidget* deviceTab) {
+	deviceTab->SetDeviceName(m_server->GetClient()->GetDeviceName());
+	deviceTab->SetIdentifier(m_server->GetClient()->GetIdentifier());
+	deviceTab->SetAddress(m_server->GetClient()->GetAddressString());
+	deviceTab->SetAppVersion(m_server->GetClient()->GetAppVersion());
+	deviceTab->SetOS(m_server->GetClient()->GetOSType(),
+					 m_server->GetClient()->GetOSVersion());
+
+	deviceTab->SetFeatures(m_server->GetClient()->HasNotifications(),
+						   m_server->GetClient()->HasSMS());
+}
+
+void MainWidget::ExpireContent() {
+	m_graceTimer->stop();
+
+	m_clientIdentifier = QString();
+	m_contentRestored = false;
+
+	m_bridge->ResetNotifications();
+
+	m_toastScheduler->Clear();
+	m_notificationThrottle->Clear();
+
+	m_restoredSMSList.Clear();
+	m_restoredThreads.clear();
+
+	if (m_notificationsTab.Peek() != nullptr) {
+		m_notificationsTab.Peek()->ExpireContent();
+	}
+
+	if (m_smsTab.Peek() != nullptr) {
+		m_smsTab.Peek()->ExpireContent();
+	}
+}
+
+void MainWidget::RestoreContent() {
+	if (m_store.isNull()) {
+		return;
+	}
+
+	MessageStore::Content content;
+
+	std::string error;
+
+	if (!m_store->Load(&content, &error)) {
+		spdlog::info(std::string("Content not restored: ") + error);
+
+		return;
+	}
+
+	m_searchIdentifier = content.searchIdentifier;
+	m_searchIndex.Restore(content.documents);
+
+	if (content.clientIdentifier.isEmpty()) {
+		return;
+	}
+
+	m_clientIdentifier = content.clientIdentifier;
+	m_contentRestored = true;
+
+	m_bridge->RestoreNotifications(content.notifications);
+	m_notificationThrottle->NotificationList(content.notifications);
+
+	/* Tabs that are not built yet pick the content up when they are */
+	if (m_notificationsTab.Peek() != nullptr) {
+		m_notificationsTab.Peek()->RestoreContent(content.notifications);
+	}
+
+	if (m_smsTab.Peek() != nullptr) {
+		m_smsTab.Peek()->RestoreContent(content.smsList, content.threads);
+	} else {
+		m_restoredSMSList = std::move(content.smsList);
+		m_restoredThreads = std::move(content.threads);
+	}
 }
 
 bool MainWidget::StartServer(std::string* error) {
@@ -305,6 +463,7 @@ bool MainWidget::StartServer(std::string* error) {
 	connect(m_server, &Server::ConnectedChange, this, &MainWidget::ServerStateChanged);
 
 	connect(m_server, &Server::MessageReceived, m_bridge, &Bridge::ParseMessage);
+	connect(m_server, &Server::StreamedMessageReceived, m_bridge, &Bridge::ParseStreamedMessage);
 	connect(m_bridge, &Bridge::EmitMessage, m_server, &Server::SendMessageToClient);
 
 	UpdateServerState(ServerState::STARTED);
@@ -318,6 +477,10 @@ void MainWidget::StopServer() {
 
 		if (m_bridge != nullptr) {
 			disconnect(m_server, &Server::MessageReceived, m_bridge, &Bridge::ParseMessage);
+			disconnect(m_server,
+					   &Server::StreamedMessageReceived,
+					   m_bridge,
+					   &Bridge::ParseStreamedMessage);
 			disconnect(m_bridge, &Bridge::EmitMessage, m_server, &Server::SendMessageToClient);
 		}
 	}
@@ -344,36 +507,249 @@ void MainWidget::SetupStylesheet() {
 	styleFile.close();
 }
 
+void MainWidget::SetupKeys() {
+	/* The store and history keys are derived from the secret key */
+	if (!m_settings->contains("public_key")
+			|| !m_settings->contains("secret_key")
+			|| !m_settings->contains("identifier")) {
+		Crypto::GenerateKeyPair(m_settings);
+	}
+}
+
+void MainWidget::SetupStore() {
+	m_storeTimer = new QTimer(this);
+
+	connect(m_storeTimer, &QTimer::timeout, this, &MainWidget::SaveContent);
+
+	m_storeTimer->setInterval(STORE_SAVE_DELAY);
+	m_storeTimer->setSingleShot(true);
+
+	QString secretKey = m_settings->value("secret_key", "").toString();
+
+	if (secretKey.isEmpty()) {
+		return;
+	}
+
+	QDir configDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+
+	try {
+		m_store.reset(new MessageStore(QDir::cleanPath(configDir.absoluteFilePath(STORE_PATH)),
+									   secretKey));
+	} catch (const std::runtime_error& ex) {
+		spdlog::warn(std::string("Content store disabled: ") + ex.what());
+	}
+
+	try {
+		m_history.reset(new NotificationHistory(QDir::cleanPath(configDir.absoluteFilePath(HISTORY_PATH)),
+												secretKey));
+	} catch (const std::runtime_error& ex) {
+		spdlog::warn(std::string("Notification history disabled: ") + ex.what());
+	}
+}
+
 void MainWidget::SetupBridge() {
 	m_bridge = new Bridge(this);
 
-	connect(m_bridge, &Bridge::NotificationReceived, this, [&](const Notification & notification) {
-		QString identifier = "notif_" + notification.key;
-		QString text = notification.appName + "\n" + notification.title;
+	m_toastScheduler = new ToastScheduler(this);
+	m_toastScheduler->SetWindow(m_settings->value("notificationWindow", TOAST_COALESCE_WINDOW).toInt());
+
+	connect(m_toastScheduler,
+			&ToastScheduler::ShowToast,
+			this,
+			&MainWidget::ShowVRNotification);
+
+	connect(m_toastScheduler,
+			&ToastScheduler::RemoveToast,
+			this,
+			&MainWidget::RemoveVRNotification);
+
+	m_notificationThrottle = new NotificationThrottle(NOTIF_UPDATE_INTERVAL, this);
+
+	connect(m_bridge,
+			&Bridge::NotificationReceived,
+			m_notificationThrottle,
+			&NotificationThrottle::NotificationReceived);
+
+	connect(m_bridge,
+			&Bridge::NotificationRemoved,
+			m_notificationThrottle,
+			&NotificationThrottle::NotificationRemoved);
+
+	connect(m_bridge,
+			&Bridge::NotificationList,
+			m_notificationThrottle,
+			&NotificationThrottle::NotificationList);
+
+	/* Saved once things settle, not on every message */
+	auto scheduleSave = [&]() {
+		if (!m_store.isNull() && !m_storeTimer->isActive()) {
+			m_storeTimer->start();
+		}
+	};
+
+	connect(m_bridge, &Bridge::NotificationReceived, this, scheduleSave);
+	connect(m_bridge, &Bridge::NotificationRemoved, this, scheduleSave);
+	connect(m_bridge, &Bridge::NotificationList, this, scheduleSave);
+	connect(m_bridge, &Bridge::SMSList, this, scheduleSave);
+	connect(m_bridge, &Bridge::SMSFromList, this, scheduleSave);
+	connect(m_bridge, &Bridge::SMSSent, this, scheduleSave);
+	connect(m_bridge, &Bridge::SMSReceived, this, scheduleSave);
+
+	connect(m_bridge, &Bridge::NotificationList, this, [&](const Batch<Notification> & list) {
+		for (const Notification& notification : list) {
+			m_searchIndex.AddNotification(notification);
+		}
+	});
+
+	connect(m_bridge, &Bridge::SMSList, this, [&](const Batch<SMS> & list) {
+		for (const SMS& sms : list) {
+			ShortSMS shortSms = {sms.incoming, sms.date, sms.body};
 
-		emit ShowVRNotification(identifier.toStdString(),
-								text.toStdString(),
-								m_settings->value("notificationSound", true).toBool());
+			m_searchIndex.AddSMS(sms.number.String(), sms.name.String(), shortSms);
+		}
 	});
 
-	connect(m_bridge, &Bridge::NotificationRemoved, this, [&](const Notification & notification) {
-		QString identifier = "notif_" + notification.key;
+	connect(m_bridge,
+			&Bridge::SMSFromList,
+			this,
+	[&](const QString & number, const QString & name, int, const Batch<ShortSMS> & list) {
+		for (const ShortSMS& shortSms : list) {
+			m_searchIndex.AddSMS(number, name, shortSms);
+		}
+	});
+
+	connect(m_bridge, &Bridge::SMSReceived, this, [&](const SMS & sms) {
+		ShortSMS shortSms = {sms.incoming, sms.date, sms.body};
+
+		m_searchIndex.AddSMS(sms.number.String(), sms.name.String(), shortSms);
 
-		emit RemoveVRNotification(identifier.toStdString());
+		if (m_smsTab.Peek() == nullptr) {
+			UpdateRestoredSMS(sms.number.String(), sms.name.String(), shortSms);
+		}
+	});
+
+	connect(m_notificationThrottle,
+			&NotificationThrottle::NotificationPosted,
+			this,
+	[&](const Notification & notification) {
+		/* Indexed and logged once when posted, updates would flood both */
+		m_searchIndex.AddNotification(notification);
+
+		if (!m_history.isNull()) {
+			m_history->Append(notification);
+		}
+
+		/* Updates to a visible notification never toast again */
+		m_toastScheduler->NotificationReceived(notification,
+											   m_settings->value("notificationSound", true).toBool());
 	});
 
-	connect(m_bridge, &Bridge::SMSSent, this, [&](const QString&, bool success) {
-		emit ShowVRNotification("sms_sent",
+	connect(m_bridge,
+			&Bridge::NotificationRemoved,
+			m_toastScheduler,
+			&ToastScheduler::NotificationRemoved);
+
+	connect(m_bridge, &Bridge::SMSSent, this, [&](const QString & number, bool success, const ShortSMS & shortSms) {
+		if (success) {
+			m_searchIndex.AddSMS(number, QString(), shortSms);
+
+			if (m_smsTab.Peek() == nullptr) {
+				UpdateRestoredSMS(number, QString(), shortSms);
+			}
+		}
+
+		emit ShowVRNotification(InternedString(SYSTEM_NOTIFICATION_PREFIX "sms_sent"),
 								(success ? "SMS sent" : "Failed to send SMS"),
 								false);
 	});
 }
 
+void MainWidget::UpdateRestoredSMS(const QString& number, const QString& name, const ShortSMS& shortSms) {
+	/* Kept up to date for the store and the SMS tab until the tab is built */
+	InternedString key(number);
+
+	if (!m_restoredSMSList.IsEmpty()) {
+		SMS sms = {shortSms.incoming, shortSms.date, shortSms.body, key, InternedString(name)};
+
+		auto existing = std::find_if(m_restoredSMSList.begin(),
+									 m_restoredSMSList.end(),
+		[&](const SMS & entry) {
+			return (entry.number == key);
+		});
+
+		/* Sent SMS do not carry the contact name */
+		if (name.isEmpty() && existing != m_restoredSMSList.end()) {
+			sms.name = existing->name;
+		}
+
+		Batch<SMS> list;
+
+		list.Reserve(m_restoredSMSList.Size() + 1);
+		list.Append(std::move(sms));
+
+		for (const SMS& entry : m_restoredSMSList) {
+			if (entry.number != key) {
+				list.Append(entry);
+			}
+		}
+
+		m_restoredSMSList = std::move(list);
+	}
+
+	auto thread = std::find_if(m_restoredThreads.begin(),
+							   m_restoredThreads.end(),
+	[&](const SMSCache::Thread & entry) {
+		return (entry.number == number);
+	});
+
+	if (thread == m_restoredThreads.end()) {
+		return;
+	}
+
+	/* Without a date it cannot be placed, the tab loads the thread again */
+	if (!shortSms.date.isValid()) {
+		m_restoredThreads.erase(thread);
+		return;
+	}
+
+	/* Page 0 keeps its size, the oldest message moves to the next page */
+	int size = std::max(thread->list.Size(), 1);
+
+	Batch<ShortSMS> list;
+
+	list.Reserve(size);
+	list.Append(shortSms);
+
+	for (const ShortSMS& cached : thread->list) {
+		if (list.Size() >= size) {
+			break;
+		}
+
+		list.Append(cached);
+	}
+
+	thread->list = std::move(list);
+
+	/* Most recent first, like the cache hands them out */
+	std::rotate(m_restoredThreads.begin(), thread, thread + 1);
+}
+
 void MainWidget::SetupTabs() {
-	SetupNotificationsTab();
-	SetupSMSTab();
-	SetupDeviceTab();
-	SetupSettingsTab();
+	m_notificationsTab.SetFactory([&]() {
+		return SetupNotificationsTab();
+	});
+
+	m_smsTab.SetFactory([&]() {
+		return SetupSMSTab();
+	});
+
+	m_deviceTab.SetFactory([&]() {
+		return SetupDeviceTab();
+	});
+
+	m_settingsTab.SetFactory([&]() {
+		return SetupSettingsTab();
+	});
 
 	SwitchTab(Tab::SETTINGS, false);
 }
@@ -381,12 +757,6 @@ void MainWidget::SetupTabs() {
 void MainWidget::SetupServer() {
 	UpdateServerState(ServerState::STOPPED);
 
-	if (!m_settings->contains("public_key")
-			|| !m_settings->contains("secret_key")
-			|| !m_settings->contains("identifier")) {
-		Crypto::GenerateKeyPair(m_settings);
-	}
-
 	QSizePolicy sizePolicy = ui->identifierLabel->sizePolicy();
 	sizePolicy.setRetainSizeWhenHidden(true);
 	ui->identifierLabel->setSizePolicy(sizePolicy);
@@ -404,97 +774,150 @@ void MainWidget::SetupServer() {
 	}
 }
 
-void MainWidget::SetupNotificationsTab() {
+NotificationsTabWidget* MainWidget::SetupNotificationsTab() {
 	QGraphicsOpacityEffect* m_notificationsEffect = new QGraphicsOpacityEffect(this);
 	m_notificationsEffect->setOpacity(OPACITY_EFFECT_MAX);
 
-	m_notificationsTab = new NotificationsTabWidget(this);
-	m_notificationsTab->setVisible(false);
-	m_notificationsTab->setGraphicsEffect(m_notificationsEffect);
+	NotificationsTabWidget* notificationsTab = new NotificationsTabWidget(this);
+	notificationsTab->setVisible(false);
+	notificationsTab->setGraphicsEffect(m_notificationsEffect);
+	notificationsTab->SetHistory(m_history.data());
+	notificationsTab->SetSearchIndex(&m_searchIndex);
+	notificationsTab->OverlayVisibilityChanged(m_overlayVisible);
 
-	connect(m_bridge,
-			&Bridge::NotificationReceived,
-			m_notificationsTab,
+	connect(notificationsTab,
+			&NotificationsTabWidget::ShowVRKeyboard,
+			this,
+			&MainWidget::ShowVRKeyboard);
+
+	connect(m_notificationThrottle,
+			&NotificationThrottle::NotificationPosted,
+			notificationsTab,
+			&NotificationsTabWidget::NotificationReceived);
+
+	connect(m_notificationThrottle,
+			&NotificationThrottle::NotificationUpdated,
+			notificationsTab,
 			&NotificationsTabWidget::NotificationReceived);
 
 	connect(m_bridge,
 			&Bridge::NotificationRemoved,
-			m_notificationsTab,
+			notificationsTab,
 			&NotificationsTabWidget::NotificationRemoved);
 
 	connect(m_bridge,
 			&Bridge::NotificationList,
-			m_notificationsTab,
+			notificationsTab,
 			&NotificationsTabWidget::NotificationList);
 
-	connect(m_notificationsTab,
+	connect(notificationsTab,
 			&NotificationsTabWidget::ListNotifications,
 			m_bridge,
 			&Bridge::ListNotifications);
 
-	connect(m_notificationsTab,
+	connect(notificationsTab,
 			&NotificationsTabWidget::DismissNotification,
 			m_bridge,
 			&Bridge::DismissNotification);
 
-	ui->contentLayout->addWidget(m_notificationsTab, 0, Qt::AlignHCenter);
+	connect(notificationsTab,
+			&NotificationsTabWidget::DismissNotifications,
+			m_bridge,
+			&Bridge::DismissNotifications);
+
+	if (m_serverState == ServerState::CONNECTED && m_server != nullptr) {
+		notificationsTab->SetFeatureEnabled(m_server->GetClient()->HasNotifications());
+	}
+
+	notificationsTab->ServerStateChanged(m_serverState);
+
+	/* Everything received so far is in the bridge mirror */
+	Batch<Notification> list;
+
+	if (m_bridge->GetNotifications(&list)) {
+		notificationsTab->RestoreContent(list);
+	}
+
+	ui->contentLayout->addWidget(notificationsTab, 0, Qt::AlignHCenter);
+
+	return notificationsTab;
 }
 
-void MainWidget::SetupSMSTab() {
+SMSTabWidget* MainWidget::SetupSMSTab() {
 	QGraphicsOpacityEffect* m_smsEffect = new QGraphicsOpacityEffect(this);
 	m_smsEffect->setOpacity(OPACITY_EFFECT_MAX);
 
-	m_smsTab = new SMSTabWidget(this);
-	m_smsTab->setVisible(false);
-	m_smsTab->setGraphicsEffect(m_smsEffect);
+	SMSTabWidget* smsTab = new SMSTabWidget(this);
+	smsTab->setVisible(false);
+	smsTab->setGraphicsEffect(m_smsEffect);
 
-	connect(m_smsTab,
+	connect(smsTab,
 			&SMSTabWidget::ShowVRKeyboard,
 			this,
 			&MainWidget::ShowVRKeyboard);
 
 	connect(m_bridge,
 			&Bridge::SMSList,
-			m_smsTab,
+			smsTab,
 			&SMSTabWidget::SMSList);
 
 	connect(m_bridge,
 			&Bridge::SMSFromList,
-			m_smsTab,
+			smsTab,
 			&SMSTabWidget::SMSFromList);
 
 	connect(m_bridge,
 			&Bridge::SMSSent,
-			m_smsTab,
+			smsTab,
 			&SMSTabWidget::SMSSent);
 
-	connect(m_smsTab,
+	connect(m_bridge,
+			&Bridge::SMSReceived,
+			smsTab,
+			&SMSTabWidget::SMSReceived);
+
+	connect(smsTab,
 			&SMSTabWidget::ListSMS,
 			m_bridge,
 			&Bridge::ListSMS);
 
-	connect(m_smsTab,
+	connect(smsTab,
 			&SMSTabWidget::ListSMSFrom,
 			m_bridge,
 			&Bridge::ListSMSFrom);
 
-	connect(m_smsTab,
+	connect(smsTab,
 			&SMSTabWidget::SendSMS,
 			m_bridge,
 			&Bridge::SendSMS);
 
-	ui->contentLayout->addWidget(m_smsTab, 0, Qt::AlignHCenter);
+	if (m_serverState == ServerState::CONNECTED && m_server != nullptr) {
+		smsTab->SetFeatureEnabled(m_server->GetClient()->HasSMS());
+	}
+
+	smsTab->ServerStateChanged(m_serverState);
+
+	if (!m_restoredSMSList.IsEmpty() || !m_restoredThreads.empty()) {
+		smsTab->RestoreContent(m_restoredSMSList, m_restoredThreads);
+
+		m_restoredSMSList.Clear();
+		m_restoredThreads.clear();
+	}
+
+	ui->contentLayout->addWidget(smsTab, 0, Qt::AlignHCenter);
+
+	return smsTab;
 }
 
-void MainWidget::SetupDeviceTab() {
+DeviceTabWidget* MainWidget::SetupDeviceTab() {
 	QGraphicsOpacityEffect* m_deviceEffect = new QGraphicsOpacityEffect(this);
 	m_deviceEffect->setOpacity(OPACITY_EFFECT_MAX);
 
-	m_deviceTab = new DeviceTabWidget(this);
-	m_deviceTab->setVisible(false);
-	m_deviceTab->setGraphicsEffect(m_deviceEffect);
+	DeviceTabWidget* deviceTab = new DeviceTabWidget(this);
+	deviceTab->setVisible(false);
+	deviceTab->setGraphicsEffect(m_deviceEffect);
 
-	connect(m_deviceTab,
+	connect(deviceTab,
 			&DeviceTabWidget::KickClient,
 			this,
 	[&]() {
@@ -503,28 +926,36 @@ void MainWidget::SetupDeviceTab() {
 		}
 	});
 
-	ui->contentLayout->addWidget(m_deviceTab, 0, Qt::AlignHCenter);
+	if (m_serverState == ServerState::CONNECTED && m_server != nullptr) {
+		UpdateDeviceTab(deviceTab);
+	}
+
+	deviceTab->ServerStateChanged(m_serverState);
+
+	ui->contentLayout->addWidget(deviceTab, 0, Qt::AlignHCenter);
+
+	return deviceTab;
 }
 
-void MainWidget::SetupSettingsTab() {
+SettingsTabWidget* MainWidget::SetupSettingsTab() {
 	QGraphicsOpacityEffect* m_settingsEffect = new QGraphicsOpacityEffect(this);
 	m_settingsEffect->setOpacity(OPACITY_EFFECT_MAX);
 
-	m_settingsTab = new SettingsTabWidget(m_settings, this);
-	m_settingsTab->setVisible(false);
-	m_settingsTab->setGraphicsEffect(m_settingsEffect);
+	SettingsTabWidget* settingsTab = new SettingsTabWidget(m_settings, this);
+	settingsTab->setVisible(false);
+	settingsTab->setGraphicsEffect(m_settingsEffect);
 
-	connect(m_settingsTab,
+	connect(settingsTab,
 			&SettingsTabWidget::ShowVRNotification,
 			this,
 			&MainWidget::ShowVRNotification);
 
-	connect(m_settingsTab,
+	connect(settingsTab,
 			&SettingsTabWidget::ShowVRKeyboard,
 			this,
 			&MainWidget::ShowVRKeyboard);
 
-	connect(m_settingsTab,
+	connect(settingsTab,
 			&SettingsTabWidget::StartServer,
 			this,
 	[&]() {
@@ -533,14 +964,20 @@ void MainWidget::SetupSettingsTab() {
 		if (!StartServer(&error)) {
 			error.insert(0, "Failed to start server\n");
 
-			emit ShowVRNotification("start_failed", error, false);
+			emit ShowVRNotification(InternedString(SYSTEM_NOTIFICATION_PREFIX "start_failed"),
+									error,
+									false);
 		}
 	});
 
-	connect(m_settingsTab,
+	connect(settingsTab,
 			&SettingsTabWidget::StopServer,
 			this,
 			&MainWidget::StopServer);
 
-	ui->contentLayout->addWidget(m_settingsTab, 0, Qt::AlignHCenter);
+	settingsTab->ServerStateChanged(m_serverState);
+
+	ui->contentLayout->addWidget(settingsTab, 0, Qt::AlignHCenter);
+
+	return settingsTab;
 }
@@ -1,14 +1,24 @@
 #pragma once
 
+#include <vector>
+
 #include <QDir>
+#include <QTimer>
 #include <QWidget>
 #include <QSettings>
+#include <QScopedPointer>
 
 #include "../common.h"
 #include "../server.h"
 #include "../bridge.h"
+#include "../message_store.h"
+#include "../notification_history.h"
+#include "../search_index.h"
+#include "../toast_scheduler.h"
+#include "../notification_throttle.h"
 
 #include "fade_widget.h"
+#include "lazy_tab.h"
 
 #include "tabs/notifications_tab_widget.h"
 #include "tabs/sms_tab_widget.h"
@@ -28,11 +38,14 @@ class MainWidget : public FadeWidget {
 
 	public slots:
 		void VROverlayShown();
-		void VRNotificationOpened(const std::string& identifier);
+		void VROverlayHidden();
+		void VRNotificationOpened(const InternedString& identifier);
 		void VRKeyboardData(uint8_t identifier, const std::string& data);
 
 	private slots:
 		void ServerStateChanged(bool connected);
+		void GracePeriodExpired();
+		void SaveContent();
 
 		void on_notificationsButton_clicked();
 		void on_smsButton_clicked();
@@ -40,11 +53,11 @@ class MainWidget : public FadeWidget {
 		void on_settingsButton_clicked();
 
 	signals:
-		void ShowVRNotification(const std::string& identifier,
+		void ShowVRNotification(const InternedString& identifier,
 								const std::string& text,
 								bool sound = true,
 								bool persistent = false);
-		void RemoveVRNotification(const std::string& identifier);
+		void RemoveVRNotification(const InternedString& identifier);
 		void ShowVRKeyboard(uint8_t identifier,
 							uint32_t maxLen,
 							const char* initialText = nullptr,
@@ -58,31 +71,59 @@ class MainWidget : public FadeWidget {
 		Tab m_currentTab;
 		ServerState m_serverState;
 
+		QTimer* m_graceTimer;
+		QString m_clientIdentifier;
+
+		QScopedPointer<MessageStore> m_store;
+		QTimer* m_storeTimer;
+		bool m_contentRestored;
+
+		QScopedPointer<NotificationHistory> m_history;
+
+		SearchIndex m_searchIndex;
+		QString m_searchIdentifier;
+
 		QPointer<QSettings> m_settings;
 
 		QPointer<Bridge> m_bridge;
+		ToastScheduler* m_toastScheduler;
+		NotificationThrottle* m_notificationThrottle;
 		QPointer<Server> m_server;
 
-		NotificationsTabWidget* m_notificationsTab;
-		SMSTabWidget* m_smsTab;
-		DeviceTabWidget* m_deviceTab;
-		SettingsTabWidget* m_settingsTab;
+		/* Built on first activation */
+		LazyTab<NotificationsTabWidget> m_notificationsTab;
+		LazyTab<SMSTabWidget> m_smsTab;
+		LazyTab<DeviceTabWidget> m_deviceTab;
+		LazyTab<SettingsTabWidget> m_settingsTab;
+
+		bool m_overlayVisible;
+
+		/* Handed to the SMS tab when it is built */
+		Batch<SMS> m_restoredSMSList;
+		std::vector<SMSCache::Thread> m_restoredThreads;
 
 		QWidget* GetTabWidget(const Tab& tab);
 		void SwitchTab(const Tab& tab, bool animate = true);
+		void ShowTab(QWidget* widget);
+		void UpdateDeviceTab(DeviceTabWidget* deviceTab);
 
 		void UpdateServerState(const ServerState& state);
+		void ExpireContent();
+		void RestoreContent();
+		void UpdateRestoredSMS(const QString& number, const QString& name, const ShortSMS& shortSms);
 
 		bool StartServer(std::string* error = nullptr);
 		void StopServer();
 
 		void SetupStylesheet();
+		void SetupKeys();
+		void SetupStore();
 		void SetupBridge();
 		void SetupTabs();
 		void SetupServer();
 
-		void SetupNotificationsTab();
-		void SetupSMSTab();
-		void SetupDeviceTab();
-		void SetupSettingsTab();
+		NotificationsTabWidget* SetupNotificationsTab();
+		SMSTabWidget* SetupSMSTab();
+		DeviceTabWidget* SetupDeviceTab();
+		SettingsTabWidget* SetupSettingsTab();
 };
@@ -0,0 +1,249 @@
+#include <algorithm>
+
+#include <QEvent>
+#include <QPainter>
+#include <QMouseEvent>
+#include <QAbstractItemView>
+
+#include "notification_item_delegate.h"
+#include "notification_list_model.h"
+#include "theme.h"
+#include "../common.h"
+
+#define STACK_HEIGHT        6
+#define STACK_INSET         10
+#define DISMISS_PADDING_X   10
+#define DISMISS_PADDING_Y   14
+
+NotificationItemDelegate::NotificationItemDelegate(QObject* parent)
+	: QStyledItemDelegate(parent) {
+}
+
+void NotificationItemDelegate::paint(QPainter* painter,
+									 const QStyleOptionViewItem& option,
+									 const QModelIndex& index) const {
+	const Theme& theme = Theme::Get();
+
+	bool enabled = (option.state & QStyle::State_Enabled);
+	bool group = index.data(NotificationListModel::GroupRole).toBool();
+	bool persistent = index.data(NotificationListModel::PersistentRole).toBool();
+
+	QRect rect = CardRect(option, index);
+
+	painter->save();
+
+	if (group && !IsHeader(index)) {
+		/* Collapsed groups look like a stack of cards */
+		painter->fillRect(QRect(rect.left() + STACK_INSET,
+								rect.bottom() + 1,
+								rect.width() - 2 * STACK_INSET,
+								STACK_HEIGHT),
+						  theme.cardStack);
+	}
+
+	bool hovered = (enabled && group && (option.state & QStyle::State_MouseOver));
+
+	painter->fillRect(rect, hovered ? theme.itemHover : theme.card);
+
+	QRect content = rect.adjusted(theme.itemMargin, theme.itemMargin, -theme.itemMargin, -theme.itemMargin);
+
+	int textWidth = TextWidth(option, index);
+
+	int y = content.top();
+
+	painter->setFont(theme.appNameFont);
+	painter->setPen(enabled ? theme.appNameColor : theme.disabledColor);
+
+	int height = theme.appNameMetrics.height();
+
+	if (IsHeader(index)) {
+		painter->drawText(QRect(content.left(), content.top(), textWidth, content.height()),
+						  Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+						  AppLabel(index));
+	} else {
+		painter->drawText(QRect(content.left(), y, content.width(), height),
+						  Qt::AlignHCenter | Qt::AlignVCenter | Qt::TextSingleLine,
+						  AppLabel(index));
+
+		y += height;
+
+		painter->setFont(theme.titleFont);
+		painter->setPen(enabled ? theme.titleColor : theme.disabledColor);
+
+		height = theme.titleMetrics.height();
+
+		QString title = ellipsize(index.data(NotificationListModel::TitleRole).toString(), NOTIF_TITLE_MAX_LENGTH);
+
+		painter->drawText(QRect(content.left(), y, textWidth, height),
+						  Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+						  theme.titleMetrics.elidedText(title, Qt::ElideRight, textWidth));
+
+		y += height;
+
+		painter->setFont(theme.textFont);
+		painter->setPen(enabled ? theme.textColor : theme.disabledColor);
+
+		painter->drawText(QRect(content.left(), y, textWidth, content.bottom() - y + 1),
+						  Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap,
+						  ellipsize(index.data(NotificationListModel::TextRole).toString(), NOTIF_TEXT_MAX_LENGTH));
+	}
+
+	if (!persistent) {
+		bool dismissHovered = (enabled
+							   && (option.state & QStyle::State_MouseOver)
+							   && m_dismissHovered == index);
+
+		painter->setFont(theme.smallFont);
+		painter->setPen(dismissHovered ? theme.dimHoverColor : (enabled ? theme.dimColor : theme.disabledColor));
+
+		painter->drawText(DismissRect(option, index),
+						  Qt::AlignCenter | Qt::TextSingleLine,
+						  DismissLabel(index));
+	}
+
+	painter->restore();
+}
+
+QSize NotificationItemDelegate::sizeHint(const QStyleOptionViewItem& option,
+		const QModelIndex& index) const {
+	const Theme& theme = Theme::Get();
+
+	bool group = index.data(NotificationListModel::GroupRole).toBool();
+	bool persistent = index.data(NotificationListModel::PersistentRole).toBool();
+
+	const QAbstractItemView* view = qobject_cast<const QAbstractItemView*>(option.widget);
+
+	int width = (view != nullptr) ? view->viewport()->width() : option.rect.width();
+
+	QStyleOptionViewItem sized(option);
+	sized.rect.setWidth(width);
+
+	int height = theme.appNameMetrics.height();
+
+	if (!IsHeader(index)) {
+		QString text = ellipsize(index.data(NotificationListModel::TextRole).toString(), NOTIF_TEXT_MAX_LENGTH);
+
+		height += theme.titleMetrics.height()
+				  + theme.textMetrics.boundingRect(QRect(0, 0, TextWidth(sized, index), 0),
+												   Qt::AlignLeft | Qt::TextWordWrap,
+												   text).height();
+	}
+
+	if (!persistent) {
+		height = std::max(height, theme.smallMetrics.height() + 2 * DISMISS_PADDING_Y);
+	}
+
+	height += 2 * theme.itemMargin + theme.itemSpacing;
+
+	if (group && !IsHeader(index)) {
+		height += STACK_HEIGHT;
+	}
+
+	return QSize(width, height);
+}
+
+bool NotificationItemDelegate::editorEvent(QEvent* event,
+		QAbstractItemModel* model,
+		const QStyleOptionViewItem& option,
+		const QModelIndex& index) {
+	if (event->type() != QEvent::MouseMove
+			&& event->type() != QEvent::MouseButtonPress
+			&& event->type() != QEvent::MouseButtonRelease) {
+		return QStyledItemDelegate::editorEvent(event, model, option, index);
+	}
+
+	QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+
+	bool group = index.data(NotificationListModel::GroupRole).toBool();
+	bool onDismiss = (!index.data(NotificationListModel::PersistentRole).toBool()
+					  && DismissRect(option, index).contains(mouseEvent->pos()));
+
+	if (event->type() == QEvent::MouseMove) {
+		QPersistentModelIndex hovered = onDismiss ? QPersistentModelIndex(index) : QPersistentModelIndex();
+
+		if (hovered != m_dismissHovered) {
+			m_dismissHovered = hovered;
+
+			const QAbstractItemView* view = qobject_cast<const QAbstractItemView*>(option.widget);
+
+			if (view != nullptr) {
+				view->viewport()->update(option.rect);
+			}
+		}
+
+		return false;
+	}
+
+	if (mouseEvent->button() != Qt::LeftButton
+			|| !(onDismiss || (group && CardRect(option, index).contains(mouseEvent->pos())))) {
+		return false;
+	}
+
+	if (event->type() == QEvent::MouseButtonRelease) {
+		QString appName = index.data(NotificationListModel::AppNameRole).toString();
+
+		if (!onDismiss) {
+			emit ToggleGroup(appName);
+		} else if (group) {
+			/* One operation for the whole group */
+			emit DismissGroup(appName);
+		} else {
+			emit Dismiss(index.data(NotificationListModel::KeyRole).toString());
+		}
+	}
+
+	return true;
+}
+
+QRect NotificationItemDelegate::CardRect(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+	int bottom = Theme::Get().itemSpacing;
+
+	if (index.data(NotificationListModel::GroupRole).toBool() && !IsHeader(index)) {
+		bottom += STACK_HEIGHT;
+	}
+
+	return option.rect.adjusted(0, 0, 0, -bottom);
+}
+
+QRect NotificationItemDelegate::DismissRect(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+	const Theme& theme = Theme::Get();
+
+	int width = theme.smallMetrics.horizontalAdvance(DismissLabel(index)) + 2 * DISMISS_PADDING_X;
+	int height = theme.smallMetrics.height() + 2 * DISMISS_PADDING_Y;
+
+	QRect rect = CardRect(option, index).adjusted(theme.itemMargin,
+				 theme.itemMargin,
+				 -theme.itemMargin,
+				 -theme.itemMargin);
+
+	return QRect(rect.right() - width + 1, rect.center().y() - height / 2, width, height);
+}
+
+int NotificationItemDelegate::TextWidth(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+	int width = option.rect.width() - 2 * Theme::Get().itemMargin;
+
+	if (!index.data(NotificationListModel::PersistentRole).toBool()) {
+		width -= DismissRect(option, index).width();
+	}
+
+	return std::max(width, 1);
+}
+
+QString NotificationItemDelegate::AppLabel(const QModelIndex& index) {
+	QString appName = index.data(NotificationListModel::AppNameRole).toString();
+
+	if (!index.data(NotificationListModel::GroupRole).toBool()) {
+		return appName;
+	}
+
+	return QString("%1 (%2)").arg(appName).arg(index.data(NotificationListModel::CountRole).toInt());
+}
+
+QString NotificationItemDelegate::DismissLabel(const QModelIndex& index) {
+	return index.data(NotificationListModel::GroupRole).toBool() ? "Dismiss all" : "Dismiss";
+}
+
+bool NotificationItemDelegate::IsHeader(const QModelIndex& index) {
+	return (index.data(NotificationListModel::GroupRole).toBool()
+			&& index.data(NotificationListModel::ExpandedRole).toBool());
+}
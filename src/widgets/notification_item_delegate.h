@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QStyledItemDelegate>
+#include <QPersistentModelIndex>
+
+/*
+ * Paints notification and group rows, only the visible ones are ever drawn
+ */
+
+class NotificationItemDelegate : public QStyledItemDelegate {
+		Q_OBJECT
+
+	public:
+		NotificationItemDelegate(QObject* parent = nullptr);
+
+		void paint(QPainter* painter,
+				   const QStyleOptionViewItem& option,
+				   const QModelIndex& index) const override;
+
+		QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+	protected:
+		bool editorEvent(QEvent* event,
+						 QAbstractItemModel* model,
+						 const QStyleOptionViewItem& option,
+						 const QModelIndex& index) override;
+
+	signals:
+		void Dismiss(const QString& key);
+		void DismissGroup(const QString& appName);
+		void ToggleGroup(const QString& appName);
+
+	private:
+		QPersistentModelIndex m_dismissHovered;
+
+		QRect CardRect(const QStyleOptionViewItem& option, const QModelIndex& index) const;
+		QRect DismissRect(const QStyleOptionViewItem& option, const QModelIndex& index) const;
+		int TextWidth(const QStyleOptionViewItem& option, const QModelIndex& index) const;
+
+		static QString AppLabel(const QModelIndex& index);
+		static QString DismissLabel(const QModelIndex& index);
+		static bool IsHeader(const QModelIndex& index);
+};
@@ -0,0 +1,665 @@
+#include <algorithm>
+
+#include "notification_list_model.h"
+
+#define GROUP_PREFIX    "group:"
+
+NotificationListModel::NotificationListModel(QObject* parent)
+	: QAbstractListModel(parent) {
+}
+
+int NotificationListModel::rowCount(const QModelIndex& parent) const {
+	if (parent.isValid()) {
+		return 0;
+	}
+
+	return static_cast<int>(m_rows.size());
+}
+
+QVariant NotificationListModel::data(const QModelIndex& index, int role) const {
+	if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+		return QVariant();
+	}
+
+	const Row& row = m_rows[static_cast<size_t>(index.row())];
+
+	switch (role) {
+		case KeyRole:
+			return row.group ? QString() : row.id;
+
+		case AppNameRole:
+			return row.appName.String();
+
+		case Qt::DisplayRole:
+		case TitleRole:
+			return RowNotification(row).title;
+
+		case TextRole:
+			return RowNotification(row).text;
+
+		case PersistentRole:
+			if (row.group) {
+				return (m_apps.find(row.appName)->dismissable == 0);
+			}
+
+			return RowNotification(row).persistent;
+
+		case GroupRole:
+			return row.group;
+
+		case CountRole:
+			return row.group ? static_cast<int>(m_apps.find(row.appName)->keys.size()) : 1;
+
+		case ExpandedRole:
+			return (row.group && m_expanded.contains(row.appName));
+
+		default:
+			return QVariant();
+	}
+}
+
+QStringList NotificationListModel::GetDismissableKeys(const QString& appName) const {
+	QStringList keys;
+
+	if (appName.isEmpty()) {
+		for (const Notification& notification : m_notifications) {
+			if (!notification.persistent) {
+				keys.append(notification.key);
+			}
+		}
+
+		return keys;
+	}
+
+	auto app = m_apps.find(InternedString(appName));
+
+	if (app == m_apps.end()) {
+		return keys;
+	}
+
+	for (const QString& key : app->keys) {
+		if (!m_notifications[static_cast<size_t>(m_positions.value(key))].persistent) {
+			keys.append(key);
+		}
+	}
+
+	return keys;
+}
+
+bool NotificationListModel::IsEmpty() const {
+	return m_notifications.empty();
+}
+
+void NotificationListModel::Assign(const Batch<Notification>& list) {
+	beginResetModel();
+
+	SetNotifications(list);
+
+	m_rows = BuildRows();
+	m_rowIndex.clear();
+
+	UpdateRowIndex(0, rowCount() - 1);
+
+	endResetModel();
+}
+
+void NotificationListModel::Reconcile(const Batch<Notification>& list) {
+	QSet<QString> changed;
+
+	/* Compared before the list replaces them, rows only hold keys */
+	for (const Notification& notification : list) {
+		auto position = m_positions.find(notification.key);
+
+		if (position == m_positions.end()) {
+			continue;
+		}
+
+		const Notification& current = m_notifications[static_cast<size_t>(position.value())];
+
+		if (current.title != notification.title
+				|| current.text != notification.text
+				|| current.persistent != notification.persistent
+				|| current.appName != notification.appName) {
+			changed.insert(notification.key);
+		}
+	}
+
+	SetNotifications(list);
+
+	ApplyRows(BuildRows());
+
+	for (const QString& key : changed) {
+		NotifyRow(key);
+	}
+
+	/* Counts and latest notifications may have changed */
+	for (auto app = m_apps.cbegin(); app != m_apps.cend(); ++app) {
+		if (IsGrouped(app.value())) {
+			NotifyRow(QString(GROUP_PREFIX) + app.key().String());
+		}
+	}
+}
+
+void NotificationListModel::Insert(const Notification& notification) {
+	auto position = m_positions.find(notification.key);
+
+	if (position != m_positions.end()) {
+		/* Updated in place, the rows keep their position */
+		Notification& current = m_notifications[static_cast<size_t>(position.value())];
+
+		if (current.appName != notification.appName) {
+			Remove(notification.key);
+			Insert(notification);
+			return;
+		}
+
+		if (current.title == notification.title
+				&& current.text == notification.text
+				&& current.persistent == notification.persistent) {
+			return;
+		}
+
+		App& app = m_apps[current.appName];
+
+		if (current.persistent != notification.persistent) {
+			app.dismissable += notification.persistent ? -1 : 1;
+		}
+
+		current.title = notification.title;
+		current.text = notification.text;
+		current.persistent = notification.persistent;
+
+		NotifyRow(current.key);
+
+		if (IsGrouped(app)) {
+			NotifyRow(QString(GROUP_PREFIX) + current.appName.String());
+		}
+
+		return;
+	}
+
+	RemoveAppRows(notification.appName);
+
+	m_notifications.insert(m_notifications.begin(), notification);
+
+	UpdatePositions(0, static_cast<int>(m_notifications.size()) - 1);
+
+	App& app = m_apps[notification.appName];
+
+	app.keys.insert(app.keys.begin(), notification.key);
+
+	if (!notification.persistent) {
+		++app.dismissable;
+	}
+
+	InsertAppRows(notification.appName);
+}
+
+void NotificationListModel::Remove(const QString& key) {
+	auto position = m_positions.find(key);
+
+	if (position == m_positions.end()) {
+		return;
+	}
+
+	int index = position.value();
+
+	InternedString appName = m_notifications[static_cast<size_t>(index)].appName;
+	bool persistent = m_notifications[static_cast<size_t>(index)].persistent;
+
+	RemoveAppRows(appName);
+
+	m_positions.erase(position);
+	m_notifications.erase(m_notifications.begin() + index);
+
+	UpdatePositions(index, static_cast<int>(m_notifications.size()) - 1);
+
+	App& app = m_apps[appName];
+
+	app.keys.erase(std::find(app.keys.begin(), app.keys.end(), key));
+
+	if (!persistent) {
+		--app.dismissable;
+	}
+
+	if (app.keys.empty()) {
+		m_apps.remove(appName);
+		return;
+	}
+
+	InsertAppRows(appName);
+}
+
+void NotificationListModel::Apply(const QStringList& removed, const std::vector<Notification>& received) {
+	QSet<QString> dropped;
+
+	dropped.reserve(removed.size() + static_cast<int>(received.size()));
+
+	QSet<InternedString> touched;
+
+	for (const QString& key : removed) {
+		auto position = m_positions.find(key);
+
+		if (position != m_positions.end()) {
+			dropped.insert(key);
+			touched.insert(m_notifications[static_cast<size_t>(position.value())].appName);
+		}
+	}
+
+	QHash<QString, const Notification*> updates;
+
+	std::vector<Notification> list;
+
+	list.reserve(m_notifications.size() + received.size());
+
+	/* Newest last in the log, what is not updated in place goes on top */
+	for (auto notification = received.rbegin(); notification != received.rend(); ++notification) {
+		auto position = m_positions.find(notification->key);
+
+		touched.insert(notification->appName);
+
+		if (position != m_positions.end()
+				&& !dropped.contains(notification->key)
+				&& m_notifications[static_cast<size_t>(position.value())].appName == notification->appName) {
+			updates.insert(notification->key, &*notification);
+			continue;
+		}
+
+		if (position != m_positions.end()) {
+			dropped.insert(notification->key);
+			touched.insert(m_notifications[static_cast<size_t>(position.value())].appName);
+		}
+
+		list.push_back(*notification);
+	}
+
+	QSet<QString> changed;
+
+	for (const Notification& current : m_notifications) {
+		if (dropped.contains(current.key)) {
+			continue;
+		}
+
+		auto update = updates.find(current.key);
+
+		if (update == updates.end()) {
+			list.push_back(current);
+			continue;
+		}
+
+		const Notification& notification = *update.value();
+
+		if (current.title != notification.title
+				|| current.text != notification.text
+				|| current.persistent != notification.persistent) {
+			changed.insert(notification.key);
+		}
+
+		list.push_back(notification);
+	}
+
+	m_notifications = std::move(list);
+
+	IndexNotifications();
+
+	/* One diff for the whole log instead of a row change per entry */
+	ApplyRows(BuildRows());
+
+	for (const QString& key : changed) {
+		NotifyRow(key);
+	}
+
+	for (const InternedString& appName : touched) {
+		auto app = m_apps.find(appName);
+
+		if (app != m_apps.end() && IsGrouped(app.value())) {
+			NotifyRow(QString(GROUP_PREFIX) + appName.String());
+		}
+	}
+}
+
+void NotificationListModel::Clear() {
+	m_expanded.clear();
+
+	if (m_rows.empty() && m_notifications.empty()) {
+		return;
+	}
+
+	beginResetModel();
+
+	m_notifications.clear();
+	m_positions.clear();
+	m_apps.clear();
+
+	m_rows.clear();
+	m_rowIndex.clear();
+
+	endResetModel();
+}
+
+void NotificationListModel::ToggleExpanded(const QString& appName) {
+	InternedString name(appName);
+
+	bool expanded = !m_expanded.contains(name);
+
+	if (expanded) {
+		m_expanded.insert(name);
+	} else {
+		m_expanded.remove(name);
+	}
+
+	auto app = m_apps.find(name);
+
+	if (app == m_apps.end() || !IsGrouped(app.value())) {
+		return;
+	}
+
+	QString id = QString(GROUP_PREFIX) + appName;
+
+	int header = m_rowIndex.value(id);
+
+	if (expanded) {
+		std::vector<Row> members;
+
+		members.reserve(app->keys.size());
+
+		for (const QString& key : app->keys) {
+			members.push_back({key, false, name});
+		}
+
+		InsertRows(header + 1, std::move(members));
+	} else {
+		RemoveRows(header + 1, header + static_cast<int>(app->keys.size()));
+	}
+
+	NotifyRow(id);
+}
+
+const Notification& NotificationListModel::RowNotification(const Row& row) const {
+	if (row.group) {
+		const App& app = *m_apps.find(row.appName);
+
+		return m_notifications[static_cast<size_t>(m_positions.value(app.keys.front()))];
+	}
+
+	return m_notifications[static_cast<size_t>(m_positions.value(row.id))];
+}
+
+bool NotificationListModel::IsGrouped(const App& app) const {
+	return (static_cast<int>(app.keys.size()) >= NOTIF_GROUP_MIN_SIZE);
+}
+
+void NotificationListModel::SetNotifications(const Batch<Notification>& list) {
+	QSet<QString> keys;
+
+	keys.reserve(list.Size());
+
+	m_notifications.clear();
+	m_notifications.reserve(static_cast<size_t>(list.Size()));
+
+	for (const Notification& notification : list) {
+		if (keys.contains(notification.key)) {
+			continue;
+		}
+
+		keys.insert(notification.key);
+
+		m_notifications.push_back(notification);
+	}
+
+	IndexNotifications();
+}
+
+void NotificationListModel::IndexNotifications() {
+	m_positions.clear();
+	m_positions.reserve(static_cast<int>(m_notifications.size()));
+
+	m_apps.clear();
+
+	for (const Notification& notification : m_notifications) {
+		m_positions.insert(notification.key, static_cast<int>(m_positions.size()));
+
+		App& app = m_apps[notification.appName];
+
+		app.keys.push_back(notification.key);
+
+		if (!notification.persistent) {
+			++app.dismissable;
+		}
+	}
+}
+
+void NotificationListModel::UpdatePositions(int first, int last) {
+	for (int i = first; i <= last; ++i) {
+		m_positions[m_notifications[static_cast<size_t>(i)].key] = i;
+	}
+}
+
+std::vector<NotificationListModel::Row> NotificationListModel::BuildRows() const {
+	std::vector<Row> rows;
+
+	rows.reserve(m_notifications.size());
+
+	for (const Notification& notification : m_notifications) {
+		const App& app = *m_apps.find(notification.appName);
+
+		if (!IsGrouped(app)) {
+			rows.push_back({notification.key, false, notification.appName});
+		} else if (app.keys.front() == notification.key) {
+			/* The group sits where its latest notification would */
+			std::vector<Row> group = BuildAppRows(notification.appName);
+
+			rows.insert(rows.end(), group.begin(), group.end());
+		}
+	}
+
+	return rows;
+}
+
+std::vector<NotificationListModel::Row> NotificationListModel::BuildAppRows(const InternedString& appName) const {
+	const App& app = *m_apps.find(appName);
+
+	std::vector<Row> rows;
+
+	if (IsGrouped(app)) {
+		rows.push_back({QString(GROUP_PREFIX) + appName.String(), true, appName});
+
+		if (!m_expanded.contains(appName)) {
+			return rows;
+		}
+	}
+
+	for (const QString& key : app.keys) {
+		rows.push_back({key, false, appName});
+	}
+
+	return rows;
+}
+
+void NotificationListModel::ApplyRows(std::vector<Row>&& target) {
+	if (m_rows.empty() || target.empty()) {
+		beginResetModel();
+
+		m_rows = std::move(target);
+		m_rowIndex.clear();
+
+		UpdateRowIndex(0, rowCount() - 1);
+
+		endResetModel();
+		return;
+	}
+
+	QSet<QString> ids;
+
+	ids.reserve(static_cast<int>(target.size()));
+
+	for (const Row& row : target) {
+		ids.insert(row.id);
+	}
+
+	/* Gone from the target, removed in ranges from the bottom */
+	int row = rowCount();
+
+	while (--row >= 0) {
+		if (ids.contains(m_rows[static_cast<size_t>(row)].id)) {
+			continue;
+		}
+
+		int last = row;
+
+		while (row > 0 && !ids.contains(m_rows[static_cast<size_t>(row - 1)].id)) {
+			--row;
+		}
+
+		RemoveRows(row, last);
+	}
+
+	/* Rows above are already in place, what is left is moved up or inserted */
+	for (row = 0; row < static_cast<int>(target.size()); ++row) {
+		Row& next = target[static_cast<size_t>(row)];
+
+		auto iterator = m_rowIndex.find(next.id);
+
+		if (iterator == m_rowIndex.end()) {
+			beginInsertRows(QModelIndex(), row, row);
+
+			m_rows.insert(m_rows.begin() + row, std::move(next));
+
+			UpdateRowIndex(row, rowCount() - 1);
+
+			endInsertRows();
+			continue;
+		}
+
+		int current = iterator.value();
+
+		/* Same key, the app may have changed */
+		m_rows[static_cast<size_t>(current)].appName = next.appName;
+
+		if (current != row) {
+			beginMoveRows(QModelIndex(), current, current, QModelIndex(), row);
+
+			std::rotate(m_rows.begin() + row,
+						m_rows.begin() + current,
+						m_rows.begin() + current + 1);
+
+			UpdateRowIndex(row, current);
+
+			endMoveRows();
+		}
+	}
+}
+
+void NotificationListModel::RemoveAppRows(const InternedString& appName) {
+	auto app = m_apps.find(appName);
+
+	if (app == m_apps.end()) {
+		return;
+	}
+
+	if (IsGrouped(app.value())) {
+		/* Header and members are contiguous */
+		int header = m_rowIndex.value(QString(GROUP_PREFIX) + appName.String());
+		int count = m_expanded.contains(appName) ? static_cast<int>(app->keys.size()) : 0;
+
+		RemoveRows(header, header + count);
+		return;
+	}
+
+	/* At most NOTIF_GROUP_MIN_SIZE - 1 rows, newest is topmost */
+	auto key = app->keys.rbegin();
+
+	while (key != app->keys.rend()) {
+		int row = m_rowIndex.value(*key);
+
+		RemoveRows(row, row);
+
+		++key;
+	}
+}
+
+void NotificationListModel::InsertAppRows(const InternedString& appName) {
+	std::vector<Row> rows = BuildAppRows(appName);
+
+	if (rows.front().group) {
+		InsertRows(FindRow(AnchorPosition(rows.front())), std::move(rows));
+		return;
+	}
+
+	for (Row& row : rows) {
+		int position = AnchorPosition(row);
+
+		std::vector<Row> single;
+		single.push_back(std::move(row));
+
+		InsertRows(FindRow(position), std::move(single));
+	}
+}
+
+void NotificationListModel::InsertRows(int row, std::vector<Row>&& rows) {
+	if (rows.empty()) {
+		return;
+	}
+
+	int count = static_cast<int>(rows.size());
+
+	beginInsertRows(QModelIndex(), row, row + count - 1);
+
+	m_rows.insert(m_rows.begin() + row,
+				  std::make_move_iterator(rows.begin()),
+				  std::make_move_iterator(rows.end()));
+
+	UpdateRowIndex(row, rowCount() - 1);
+
+	endInsertRows();
+}
+
+void NotificationListModel::RemoveRows(int first, int last) {
+	beginRemoveRows(QModelIndex(), first, last);
+
+	for (int i = first; i <= last; ++i) {
+		m_rowIndex.remove(m_rows[static_cast<size_t>(i)].id);
+	}
+
+	m_rows.erase(m_rows.begin() + first, m_rows.begin() + last + 1);
+
+	UpdateRowIndex(first, rowCount() - 1);
+
+	endRemoveRows();
+}
+
+int NotificationListModel::AnchorPosition(const Row& row) const {
+	const App& app = *m_apps.find(row.appName);
+
+	/* Members of an expanded group sort with their header */
+	if (row.group || IsGrouped(app)) {
+		return m_positions.value(app.keys.front());
+	}
+
+	return m_positions.value(row.id);
+}
+
+int NotificationListModel::FindRow(int position) const {
+	auto iterator = std::lower_bound(m_rows.begin(),
+									 m_rows.end(),
+									 position,
+	[&](const Row & row, int value) {
+		return (AnchorPosition(row) < value);
+	});
+
+	return static_cast<int>(iterator - m_rows.begin());
+}
+
+void NotificationListModel::NotifyRow(const QString& id) {
+	auto iterator = m_rowIndex.find(id);
+
+	if (iterator != m_rowIndex.end()) {
+		emit dataChanged(index(iterator.value()), index(iterator.value()));
+	}
+}
+
+void NotificationListModel::UpdateRowIndex(int first, int last) {
+	for (int row = first; row <= last; ++row) {
+		m_rowIndex[m_rows[static_cast<size_t>(row)].id] = row;
+	}
+}
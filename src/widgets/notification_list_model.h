@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include <QSet>
+#include <QHash>
+#include <QStringList>
+#include <QAbstractListModel>
+
+#include "../common.h"
+#include "../batch.h"
+
+/*
+ * Notifications shown in the notifications tab, newest first
+ *
+ * Apps with several notifications are grouped into a single row showing
+ * the count and the latest notification. An expanded group is a header
+ * row followed by the notifications it holds. Rows only refer to the
+ * notifications by key, a change only touches the rows of its own app.
+ */
+
+class NotificationListModel : public QAbstractListModel {
+		Q_OBJECT
+
+	public:
+		enum Role {
+			KeyRole = Qt::UserRole + 1,
+			AppNameRole,
+			TitleRole,
+			TextRole,
+			PersistentRole,
+			GroupRole,
+			CountRole,
+			ExpandedRole
+		};
+
+		NotificationListModel(QObject* parent = nullptr);
+
+		int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+		QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+		QStringList GetDismissableKeys(const QString& appName = QString()) const;
+		bool IsEmpty() const;
+
+		void Assign(const Batch<Notification>& list);
+		void Reconcile(const Batch<Notification>& list);
+		void Insert(const Notification& notification);
+		void Remove(const QString& key);
+		void Apply(const QStringList& removed, const std::vector<Notification>& received);
+		void Clear();
+
+		void ToggleExpanded(const QString& appName);
+
+	private:
+		struct Row {
+			QString id;
+			bool group;
+			InternedString appName;
+		};
+
+		struct App {
+			/* Newest first */
+			std::vector<QString> keys;
+			int dismissable = 0;
+		};
+
+		/* Newest first */
+		std::vector<Notification> m_notifications;
+		QHash<QString, int> m_positions;
+
+		QHash<InternedString, App> m_apps;
+		QSet<InternedString> m_expanded;
+
+		std::vector<Row> m_rows;
+		QHash<QString, int> m_rowIndex;
+
+		const Notification& RowNotification(const Row& row) const;
+		bool IsGrouped(const App& app) const;
+
+		void SetNotifications(const Batch<Notification>& list);
+		void IndexNotifications();
+		void UpdatePositions(int first, int last);
+
+		std::vector<Row> BuildRows() const;
+		std::vector<Row> BuildAppRows(const InternedString& appName) const;
+		void ApplyRows(std::vector<Row>&& target);
+
+		void RemoveAppRows(const InternedString& appName);
+		void InsertAppRows(const InternedString& appName);
+		void InsertRows(int row, std::vector<Row>&& rows);
+		void RemoveRows(int first, int last);
+
+		int AnchorPosition(const Row& row) const;
+		int FindRow(int position) const;
+		void NotifyRow(const QString& id);
+		void UpdateRowIndex(int first, int last);
+};
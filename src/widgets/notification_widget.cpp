@@ -1,71 +1,119 @@
-#include <QLabel>
+#include <algorithm>
+
+#include <QEvent>
 #include <QPainter>
-#include <QGridLayout>
-#include <QPushButton>
-#include <QStyleOption>
 
 #include "notification_widget.h"
+#include "theme.h"
+
+#define DATE_PADDING_X  10
 
-NotificationWidget::NotificationWidget(const Notification& notification, QWidget* parent)
+NotificationWidget::NotificationWidget(const Notification& notification,
+									   const QDateTime& date,
+									   QWidget* parent)
 	: QWidget(parent),
-	  m_key(notification.key),
-	  m_persistent(notification.persistent) {
-	setObjectName("NotificationWidget");
+	  m_appName(notification.appName.String()),
+	  m_title(ellipsize(notification.title, NOTIF_TITLE_MAX_LENGTH)),
+	  m_text(ellipsize(notification.text, NOTIF_TEXT_MAX_LENGTH)) {
+	if (date.isValid()) {
+		m_date = date.toLocalTime().toString("yyyy-MM-dd HH:mm");
+	}
 
-	QGridLayout* layout = new QGridLayout();
+	QSizePolicy policy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+	policy.setHeightForWidth(true);
 
-	layout->setSpacing(0);
+	setSizePolicy(policy);
+}
 
-	QLabel* appName = new QLabel(notification.appName, this);
-	appName->setObjectName("notificationAppName");
-	appName->setTextFormat(Qt::PlainText);
+bool NotificationWidget::hasHeightForWidth() const {
+	return true;
+}
 
-	layout->addWidget(appName, 0, 0, 1, 3, Qt::AlignHCenter);
+int NotificationWidget::heightForWidth(int width) const {
+	const Theme& theme = Theme::Get();
 
-	QLabel* title = new QLabel(ellipsize(notification.title, NOTIF_TITLE_MAX_LENGTH), this);
+	int height = theme.appNameMetrics.height()
+				 + theme.titleMetrics.height()
+				 + theme.textMetrics.boundingRect(QRect(0, 0, TextWidth(width), 0),
+						 Qt::AlignLeft | Qt::TextWordWrap,
+						 m_text).height();
 
-	title->setObjectName("notificationTitle");
-	title->setTextFormat(Qt::PlainText);
+	return height + 2 * theme.itemMargin;
+}
 
-	layout->addWidget(title, 1, 0, 1, 2);
+QSize NotificationWidget::sizeHint() const {
+	int width = (parentWidget() != nullptr) ? parentWidget()->width() : QWidget::sizeHint().width();
 
-	QLabel* text = new QLabel(ellipsize(notification.text, NOTIF_TEXT_MAX_LENGTH), this);
+	return QSize(width, heightForWidth(width));
+}
 
-	text->setObjectName("notificationText");
-	text->setTextFormat(Qt::PlainText);
-	text->setWordWrap(true);
+void NotificationWidget::paintEvent(QPaintEvent*) {
+	const Theme& theme = Theme::Get();
 
-	layout->addWidget(text, 2, 0, 1, 2);
+	bool enabled = isEnabled();
 
-	if (notification.persistent) {
-		layout->addItem(new QSpacerItem(1, 1, QSizePolicy::Fixed, QSizePolicy::Fixed), 2, 2);
-	} else {
-		QPushButton* dismiss = new QPushButton("Dismiss", this);
-		dismiss->setObjectName("dismissButton");
+	QPainter painter(this);
 
-		connect(dismiss, &QPushButton::clicked, this, [&]() {
-			emit Dismiss(m_key);
-		});
+	painter.fillRect(rect(), theme.card);
 
-		layout->addWidget(dismiss, 0, 2, 3, 1, Qt::AlignVCenter);
-	}
+	QRect content = rect().adjusted(theme.itemMargin, theme.itemMargin, -theme.itemMargin, -theme.itemMargin);
 
-	layout->setColumnStretch(1, 1);
+	int textWidth = TextWidth(width());
+	int y = content.top();
+	int height = theme.appNameMetrics.height();
 
-	setLayout(layout);
-}
+	painter.setFont(theme.appNameFont);
+	painter.setPen(enabled ? theme.appNameColor : theme.disabledColor);
+
+	painter.drawText(QRect(content.left(), y, content.width(), height),
+					 Qt::AlignHCenter | Qt::AlignVCenter | Qt::TextSingleLine,
+					 m_appName);
+
+	y += height;
+	height = theme.titleMetrics.height();
+
+	painter.setFont(theme.titleFont);
+	painter.setPen(enabled ? theme.titleColor : theme.disabledColor);
 
-const QString& NotificationWidget::GetKey() {
-	return m_key;
+	painter.drawText(QRect(content.left(), y, textWidth, height),
+					 Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+					 theme.titleMetrics.elidedText(m_title, Qt::ElideRight, textWidth));
+
+	y += height;
+
+	painter.setFont(theme.textFont);
+	painter.setPen(enabled ? theme.textColor : theme.disabledColor);
+
+	painter.drawText(QRect(content.left(), y, textWidth, content.bottom() - y + 1),
+					 Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap,
+					 m_text);
+
+	if (!m_date.isEmpty()) {
+		painter.setFont(theme.smallFont);
+		painter.setPen(enabled ? theme.dimColor : theme.disabledColor);
+
+		painter.drawText(content.adjusted(0, 0, -DATE_PADDING_X, 0),
+						 Qt::AlignRight | Qt::AlignVCenter | Qt::TextSingleLine,
+						 m_date);
+	}
 }
 
-const bool& NotificationWidget::IsPersistent() {
-	return m_persistent;
+void NotificationWidget::changeEvent(QEvent* e) {
+	QWidget::changeEvent(e);
+
+	if (e->type() == QEvent::EnabledChange) {
+		update();
+	}
 }
 
-void NotificationWidget::paintEvent(QPaintEvent*) {
-	QStyleOption opt;
-	opt.init(this);
-	QPainter p(this);
-	style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+int NotificationWidget::TextWidth(int width) const {
+	const Theme& theme = Theme::Get();
+
+	width -= 2 * theme.itemMargin;
+
+	if (!m_date.isEmpty()) {
+		width -= theme.smallMetrics.horizontalAdvance(m_date) + 2 * DATE_PADDING_X;
+	}
+
+	return std::max(width, 1);
 }
@@ -1,25 +1,35 @@
 #pragma once
 
 #include <QWidget>
+#include <QDateTime>
 
 #include "../common.h"
 
+/*
+ * Read-only notification card of the history, painted from the theme
+ */
+
 class NotificationWidget : public QWidget {
 		Q_OBJECT
 
 	public:
-		NotificationWidget(const Notification& notification, QWidget* parent = nullptr);
+		NotificationWidget(const Notification& notification,
+						   const QDateTime& date = QDateTime(),
+						   QWidget* parent = nullptr);
 
-		const QString& GetKey();
-		const bool& IsPersistent();
+		bool hasHeightForWidth() const override;
+		int heightForWidth(int width) const override;
+		QSize sizeHint() const override;
 
 	protected:
 		void paintEvent(QPaintEvent* e) override;
-
-	signals:
-		void Dismiss(const QString& key);
+		void changeEvent(QEvent* e) override;
 
 	private:
-		QString m_key;
-		bool m_persistent;
+		QString m_appName;
+		QString m_title;
+		QString m_text;
+		QString m_date;
+
+		int TextWidth(int width) const;
 };
@@ -0,0 +1,81 @@
+#include <QPainter>
+#include <QDateTime>
+#include <QAbstractItemView>
+
+#include "sms_item_delegate.h"
+#include "sms_list_model.h"
+#include "theme.h"
+#include "../common.h"
+
+#define DATE_SPACING    10
+
+SMSItemDelegate::SMSItemDelegate(QObject* parent)
+	: QStyledItemDelegate(parent) {
+}
+
+void SMSItemDelegate::paint(QPainter* painter,
+							const QStyleOptionViewItem& option,
+							const QModelIndex& index) const {
+	const Theme& theme = Theme::Get();
+
+	bool enabled = (option.state & QStyle::State_Enabled);
+	bool hovered = (enabled && (option.state & QStyle::State_MouseOver));
+
+	QRect rect = option.rect.adjusted(0, 0, 0, -theme.itemSpacing);
+
+	painter->save();
+
+	painter->fillRect(rect, hovered ? theme.itemHover : theme.item);
+
+	QRect content = rect.adjusted(theme.itemMargin, theme.itemMargin, -theme.itemMargin, -theme.itemMargin);
+
+	QString date = index.data(SMSListModel::DateRole).toDateTime().toString("MM/dd/yy");
+
+	int dateWidth = theme.dateMetrics.horizontalAdvance(date);
+
+	painter->setFont(theme.dateFont);
+	painter->setPen(enabled ? theme.textColor : theme.disabledColor);
+
+	painter->drawText(QRect(content.right() - dateWidth + 1, content.top(), dateWidth, content.height()),
+					  Qt::AlignRight | Qt::AlignVCenter | Qt::TextSingleLine,
+					  date);
+
+	int textWidth = content.width() - dateWidth - DATE_SPACING;
+
+	painter->setFont(theme.titleFont);
+	painter->setPen(enabled ? theme.titleColor : theme.disabledColor);
+
+	painter->drawText(QRect(content.left(), content.top(), textWidth, theme.titleMetrics.height()),
+					  Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+					  theme.titleMetrics.elidedText(ellipsize(index.data(Qt::DisplayRole).toString(), 40),
+													Qt::ElideRight,
+													textWidth));
+
+	QString text = ellipsize(index.data(SMSListModel::BodyRole).toString(), SMS_PREVIEW_MAX_LENGTH);
+
+	if (!index.data(SMSListModel::IncomingRole).toBool()) {
+		text.prepend("You: ");
+	}
+
+	painter->setFont(theme.textFont);
+	painter->setPen(enabled ? theme.previewColor : theme.disabledColor);
+
+	painter->drawText(QRect(content.left() + 1, content.top() + theme.titleMetrics.height(),
+							textWidth - 1, theme.textMetrics.height()),
+					  Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+					  theme.textMetrics.elidedText(text, Qt::ElideRight, textWidth - 1));
+
+	painter->restore();
+}
+
+QSize SMSItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex&) const {
+	const Theme& theme = Theme::Get();
+
+	const QAbstractItemView* view = qobject_cast<const QAbstractItemView*>(option.widget);
+
+	int width = (view != nullptr) ? view->viewport()->width() : option.rect.width();
+
+	int height = theme.titleMetrics.height() + theme.textMetrics.height();
+
+	return QSize(width, height + 2 * theme.itemMargin + theme.itemSpacing);
+}
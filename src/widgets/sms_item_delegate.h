@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QStyledItemDelegate>
+
+/*
+ * Paints conversation rows of the SMS overview
+ */
+
+class SMSItemDelegate : public QStyledItemDelegate {
+		Q_OBJECT
+
+	public:
+		SMSItemDelegate(QObject* parent = nullptr);
+
+		void paint(QPainter* painter,
+				   const QStyleOptionViewItem& option,
+				   const QModelIndex& index) const override;
+
+		QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+};
@@ -0,0 +1,221 @@
+#include <algorithm>
+
+#include <QSet>
+
+#include "sms_list_model.h"
+
+SMSListModel::SMSListModel(QObject* parent)
+	: QAbstractListModel(parent) {
+}
+
+int SMSListModel::rowCount(const QModelIndex& parent) const {
+	if (parent.isValid()) {
+		return 0;
+	}
+
+	return static_cast<int>(m_smsList.size());
+}
+
+QVariant SMSListModel::data(const QModelIndex& index, int role) const {
+	if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+		return QVariant();
+	}
+
+	const SMS& sms = GetSMS(index.row());
+
+	switch (role) {
+		case NumberRole:
+			return sms.number.String();
+
+		case Qt::DisplayRole:
+			return sms.name.IsNull() ? sms.number.String() : sms.name.String();
+
+		case NameRole:
+			return sms.name.String();
+
+		case BodyRole:
+			return sms.body;
+
+		case DateRole:
+			return sms.date;
+
+		case IncomingRole:
+			return sms.incoming;
+
+		default:
+			return QVariant();
+	}
+}
+
+const SMS& SMSListModel::GetSMS(int row) const {
+	return m_smsList[static_cast<size_t>(row)];
+}
+
+bool SMSListModel::IsEmpty() const {
+	return m_smsList.empty();
+}
+
+void SMSListModel::Assign(const Batch<SMS>& list) {
+	beginResetModel();
+
+	m_smsList.clear();
+	m_smsList.reserve(static_cast<size_t>(list.Size()));
+
+	m_rows.clear();
+	m_rows.reserve(list.Size());
+
+	for (const SMS& sms : list) {
+		if (!m_rows.contains(sms.number.String())) {
+			m_rows.insert(sms.number.String(), static_cast<int>(m_smsList.size()));
+
+			m_smsList.push_back(sms);
+		}
+	}
+
+	endResetModel();
+}
+
+void SMSListModel::Reconcile(const Batch<SMS>& list) {
+	if (m_smsList.empty()) {
+		Assign(list);
+		return;
+	}
+
+	QSet<QString> numbers;
+	std::vector<const SMS*> target;
+
+	numbers.reserve(list.Size());
+	target.reserve(static_cast<size_t>(list.Size()));
+
+	for (const SMS& sms : list) {
+		if (!numbers.contains(sms.number.String())) {
+			numbers.insert(sms.number.String());
+
+			target.push_back(&sms);
+		}
+	}
+
+	/* Gone from the list, removed in ranges from the bottom */
+	int row = rowCount();
+
+	while (--row >= 0) {
+		if (numbers.contains(m_smsList[static_cast<size_t>(row)].number.String())) {
+			continue;
+		}
+
+		int last = row;
+
+		while (row > 0 && !numbers.contains(m_smsList[static_cast<size_t>(row - 1)].number.String())) {
+			--row;
+		}
+
+		beginRemoveRows(QModelIndex(), row, last);
+
+		for (int i = row; i <= last; ++i) {
+			m_rows.remove(m_smsList[static_cast<size_t>(i)].number.String());
+		}
+
+		m_smsList.erase(m_smsList.begin() + row, m_smsList.begin() + last + 1);
+
+		endRemoveRows();
+	}
+
+	UpdateRows(0, rowCount() - 1);
+
+	/* Rows above are already in place, what is left is moved up or inserted */
+	for (row = 0; row < static_cast<int>(target.size()); ++row) {
+		const SMS& sms = *target[static_cast<size_t>(row)];
+
+		auto iterator = m_rows.find(sms.number.String());
+
+		if (iterator == m_rows.end()) {
+			beginInsertRows(QModelIndex(), row, row);
+
+			m_smsList.insert(m_smsList.begin() + row, sms);
+
+			UpdateRows(row, rowCount() - 1);
+
+			endInsertRows();
+			continue;
+		}
+
+		int current = iterator.value();
+
+		if (current != row) {
+			beginMoveRows(QModelIndex(), current, current, QModelIndex(), row);
+
+			std::rotate(m_smsList.begin() + row,
+						m_smsList.begin() + current,
+						m_smsList.begin() + current + 1);
+
+			UpdateRows(row, current);
+
+			endMoveRows();
+		}
+
+		Update(row, sms);
+	}
+}
+
+void SMSListModel::MoveToTop(const SMS& sms) {
+	auto iterator = m_rows.find(sms.number.String());
+
+	if (iterator == m_rows.end()) {
+		beginInsertRows(QModelIndex(), 0, 0);
+
+		m_smsList.insert(m_smsList.begin(), sms);
+
+		UpdateRows(0, rowCount() - 1);
+
+		endInsertRows();
+		return;
+	}
+
+	int row = iterator.value();
+
+	if (row != 0) {
+		beginMoveRows(QModelIndex(), row, row, QModelIndex(), 0);
+
+		std::rotate(m_smsList.begin(), m_smsList.begin() + row, m_smsList.begin() + row + 1);
+
+		UpdateRows(0, row);
+
+		endMoveRows();
+	}
+
+	Update(0, sms);
+}
+
+void SMSListModel::Clear() {
+	if (m_smsList.empty()) {
+		return;
+	}
+
+	beginResetModel();
+
+	m_smsList.clear();
+	m_rows.clear();
+
+	endResetModel();
+}
+
+void SMSListModel::Update(int row, const SMS& sms) {
+	SMS& current = m_smsList[static_cast<size_t>(row)];
+
+	if (current.date == sms.date
+			&& current.incoming == sms.incoming
+			&& current.body == sms.body
+			&& current.name == sms.name) {
+		return;
+	}
+
+	current = sms;
+
+	emit dataChanged(index(row), index(row));
+}
+
+void SMSListModel::UpdateRows(int first, int last) {
+	for (int row = first; row <= last; ++row) {
+		m_rows[m_smsList[static_cast<size_t>(row)].number.String()] = row;
+	}
+}
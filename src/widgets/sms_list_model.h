@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include <QHash>
+#include <QAbstractListModel>
+
+#include "../common.h"
+#include "../batch.h"
+
+/*
+ * Latest SMS of each conversation, newest first
+ */
+
+class SMSListModel : public QAbstractListModel {
+		Q_OBJECT
+
+	public:
+		enum Role {
+			NumberRole = Qt::UserRole + 1,
+			NameRole,
+			BodyRole,
+			DateRole,
+			IncomingRole
+		};
+
+		SMSListModel(QObject* parent = nullptr);
+
+		int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+		QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+		const SMS& GetSMS(int row) const;
+		bool IsEmpty() const;
+
+		void Assign(const Batch<SMS>& list);
+		void Reconcile(const Batch<SMS>& list);
+		void MoveToTop(const SMS& sms);
+		void Clear();
+
+	private:
+		std::vector<SMS> m_smsList;
+		QHash<QString, int> m_rows;
+
+		void Update(int row, const SMS& sms);
+		void UpdateRows(int first, int last);
+};
@@ -1,12 +1,12 @@
 #include <QTimer>
 #include <QScrollBar>
-#include <QSvgWidget>
-#include <QSvgRenderer>
 
 #include "notifications_tab_widget.h"
 #include "ui_notifications_tab_widget.h"
 
 #include "../notification_widget.h"
+#include "../notification_item_delegate.h"
+#include "../loading_spinner.h"
 
 NotificationsTabWidget::NotificationsTabWidget(QWidget* parent)
 	: QWidget(parent),
@@ -14,17 +14,49 @@ NotificationsTabWidget::NotificationsTabWidget(QWidget* parent)
 	  m_tab(Tab::NONE),
 	  m_serverState(ServerState::NONE),
 	  m_featureEnabled(false),
+	  m_overlayVisible(true),
 	  m_retryTimer(nullptr),
 	  m_contentLoaded(false),
-	  m_contentEmpty(true) {
+	  m_contentEmpty(true),
+	  m_contentStale(false),
+	  m_model(nullptr),
+	  m_history(nullptr),
+	  m_historyMode(false),
+	  m_historyCursor(0),
+	  m_searchIndex(nullptr) {
 	ui->setupUi(this);
 
-	QSvgWidget* loader = new QSvgWidget(":/images/loading.svg", this);
-	loader->renderer()->setFramesPerSecond(60);
-	loader->setFixedSize(70, 70);
+	LoadingSpinner* loader = new LoadingSpinner(SPINNER_SIZE, this);
 
 	ui->loadingLayout->insertWidget(0, loader, 0, Qt::AlignHCenter);
 
+	m_model = new NotificationListModel(this);
+
+	NotificationItemDelegate* delegate = new NotificationItemDelegate(this);
+
+	connect(delegate,
+			&NotificationItemDelegate::Dismiss,
+			this,
+			&NotificationsTabWidget::DismissNotification);
+
+	connect(delegate, &NotificationItemDelegate::DismissGroup, this, [&](const QString & appName) {
+		emit DismissNotifications(m_model->GetDismissableKeys(appName));
+	});
+
+	connect(delegate, &NotificationItemDelegate::ToggleGroup, this, [&](const QString & appName) {
+		m_model->ToggleExpanded(appName);
+	});
+
+	/* Updated text can change the row height */
+	connect(m_model, &NotificationListModel::dataChanged, delegate, [delegate](const QModelIndex & index) {
+		emit delegate->sizeHintChanged(index);
+	});
+
+	ui->contentListView->setModel(m_model);
+	ui->contentListView->setItemDelegate(delegate);
+	ui->contentListView->setMouseTracking(true);
+	ui->contentListView->viewport()->setAttribute(Qt::WA_Hover);
+
 	m_retryTimer = new QTimer(this);
 
 	connect(m_retryTimer, &QTimer::timeout, this, &NotificationsTabWidget::LoadContent);
@@ -35,6 +67,8 @@ NotificationsTabWidget::NotificationsTabWidget(QWidget* parent)
 	ui->statusLabel->setVisible(false);
 	ui->loadingWidget->setVisible(false);
 	ui->contentWidget->setVisible(false);
+	ui->historyWidget->setVisible(false);
+	ui->historyButton->setVisible(false);
 }
 
 NotificationsTabWidget::~NotificationsTabWidget() {
@@ -45,20 +79,55 @@ void NotificationsTabWidget::SetFeatureEnabled(bool enabled) {
 	m_featureEnabled = enabled;
 }
 
+void NotificationsTabWidget::SetHistory(NotificationHistory* history) {
+	m_history = history;
+
+	ui->historyButton->setVisible(m_history != nullptr || m_searchIndex != nullptr);
+}
+
+void NotificationsTabWidget::SetSearchIndex(const SearchIndex* searchIndex) {
+	m_searchIndex = searchIndex;
+
+	ui->historyButton->setVisible(m_history != nullptr || m_searchIndex != nullptr);
+	ui->searchLineEdit->setVisible(m_searchIndex != nullptr);
+}
+
+void NotificationsTabWidget::RestoreContent(const Batch<Notification>& list) {
+	NotificationList(list);
+
+	if (m_contentLoaded) {
+		m_contentStale = true;
+
+		UpdateLayout();
+	}
+}
+
 void NotificationsTabWidget::CurrentTabChanged(const Tab& tab) {
 	m_tab = tab;
 
+	ApplyPendingChanges();
+
 	if (m_serverState == ServerState::CONNECTED && m_tab == Tab::NOTIFICATIONS) {
 		QTimer::singleShot(LOAD_DELAY, this, &NotificationsTabWidget::LoadContent);
 	}
 }
 
+void NotificationsTabWidget::OverlayVisibilityChanged(bool visible) {
+	m_overlayVisible = visible;
+
+	ApplyPendingChanges();
+}
+
 void NotificationsTabWidget::ServerStateChanged(const ServerState& state) {
 	m_serverState = state;
 
 	setUpdatesEnabled(false);
 
-	ClearContent();
+	if (m_contentLoaded) {
+		m_contentStale = true;
+	} else {
+		ClearContent();
+	}
 
 	UpdateLayout();
 
@@ -67,9 +136,60 @@ void NotificationsTabWidget::ServerStateChanged(const ServerState& state) {
 	}
 }
 
+void NotificationsTabWidget::ExpireContent() {
+	if (!m_contentLoaded && !m_contentStale) {
+		return;
+	}
+
+	setUpdatesEnabled(false);
+
+	ClearContent();
+
+	UpdateLayout();
+}
+
+void NotificationsTabWidget::VRKeyboardData(uint8_t identifier, const std::string& data) {
+	if (identifier == KEYBOARD_INPUT_SEARCH && m_historyMode) {
+		ui->searchLineEdit->setText(QString::fromStdString(trim(data)).left(ui->searchLineEdit->maxLength()));
+	}
+}
+
+bool NotificationsTabWidget::IsShown() const {
+	return (m_overlayVisible && m_tab == Tab::NOTIFICATIONS);
+}
+
+void NotificationsTabWidget::ApplyPendingChanges() {
+	if (!IsShown() || m_changeLog.IsEmpty()) {
+		return;
+	}
+
+	m_model->Apply(m_changeLog.RemovedKeys(), m_changeLog.ReceivedNotifications());
+
+	m_changeLog.Clear();
+
+	if (m_model->IsEmpty() != m_contentEmpty) {
+		m_contentEmpty = !m_contentEmpty;
+
+		UpdateLayout();
+	}
+}
+
 void NotificationsTabWidget::UpdateLayout() {
 	setUpdatesEnabled(false);
 
+	if (m_historyMode) {
+		ui->statusLabel->setVisible(false);
+		ui->loadingWidget->setVisible(false);
+		ui->contentWidget->setVisible(false);
+
+		ui->historyWidget->setVisible(true);
+
+		setUpdatesEnabled(true);
+		return;
+	}
+
+	ui->historyWidget->setVisible(false);
+
 	switch (m_serverState) {
 		case ServerState::STOPPED:
 			ui->loadingWidget->setVisible(false);
@@ -80,6 +200,11 @@ void NotificationsTabWidget::UpdateLayout() {
 			break;
 
 		case ServerState::STARTED:
+			if (m_contentStale) {
+				ShowStaleContent("Reconnecting…");
+				break;
+			}
+
 			ui->loadingWidget->setVisible(false);
 			ui->contentWidget->setVisible(false);
 
@@ -94,6 +219,8 @@ void NotificationsTabWidget::UpdateLayout() {
 
 				ui->statusLabel->setText("Feature disabled");
 				ui->statusLabel->setVisible(true);
+			} else if (m_contentStale) {
+				ShowStaleContent("Refreshing…");
 			} else if (!m_contentLoaded) {
 				ui->statusLabel->setVisible(false);
 				ui->contentWidget->setVisible(false);
@@ -109,9 +236,13 @@ void NotificationsTabWidget::UpdateLayout() {
 				ui->statusLabel->setVisible(false);
 				ui->loadingWidget->setVisible(false);
 
-				ui->contentWidget->setVisible(true);
+				/* Back from stale content, not on every layout pass */
+				if (!ui->contentWidget->isEnabled()) {
+					ui->contentWidget->setEnabled(true);
+					ui->contentListView->scrollToTop();
+				}
 
-				ui->contentScrollArea->verticalScrollBar()->setValue(0);
+				ui->contentWidget->setVisible(true);
 			}
 
 			break;
@@ -123,10 +254,20 @@ void NotificationsTabWidget::UpdateLayout() {
 	setUpdatesEnabled(true);
 }
 
+void NotificationsTabWidget::ShowStaleContent(const QString& status) {
+	ui->loadingWidget->setVisible(false);
+
+	ui->statusLabel->setText("<font color='#999'>" + status + "</font>");
+	ui->statusLabel->setVisible(true);
+
+	ui->contentWidget->setEnabled(false);
+	ui->contentWidget->setVisible(!m_contentEmpty);
+}
+
 void NotificationsTabWidget::LoadContent() {
 	m_retryTimer->stop();
 
-	if (m_contentLoaded
+	if ((m_contentLoaded && !m_contentStale)
 			|| m_tab != Tab::NOTIFICATIONS
 			|| m_serverState != ServerState::CONNECTED) {
 		return;
@@ -138,151 +279,223 @@ void NotificationsTabWidget::LoadContent() {
 }
 
 void NotificationsTabWidget::ClearContent() {
-	QLayoutItem* item;
+	m_model->Clear();
+	m_changeLog.Clear();
 
-	int i = ui->contentScrollLayout->count();
+	ui->contentWidget->setEnabled(true);
 
-	while (--i >= 0) {
-		item = ui->contentScrollLayout->itemAt(i);
-
-		if (item == nullptr) {
-			ui->contentScrollLayout->takeAt(i);
+	m_contentLoaded = false;
+	m_contentEmpty = true;
+	m_contentStale = false;
+}
 
-			continue;
-		}
+void NotificationsTabWidget::NotificationReceived(const Notification& notification) {
+	if (!IsShown()) {
+		/* Nothing is laid out until the tab is seen again */
+		m_changeLog.Received(notification);
+		return;
+	}
 
-		if (item->spacerItem() != nullptr) {
-			continue;
-		}
+	m_model->Insert(notification);
 
-		if (item->widget() != nullptr) {
-			item->widget()->deleteLater();
-		}
+	if (m_contentEmpty) {
+		m_contentEmpty = false;
 
-		if (item->layout() != nullptr) {
-			item->layout()->deleteLater();
-		}
+		UpdateLayout();
+	}
+}
 
-		delete ui->contentScrollLayout->takeAt(i);
+void NotificationsTabWidget::NotificationRemoved(const Notification& notification) {
+	if (!IsShown()) {
+		m_changeLog.Removed(notification.key);
+		return;
 	}
 
-	m_contentLoaded = false;
-	m_contentEmpty = true;
+	m_model->Remove(notification.key);
+
+	if (m_model->IsEmpty()) {
+		m_contentEmpty = true;
+
+		UpdateLayout();
+	}
 }
 
-void NotificationsTabWidget::InsertNotification(const Notification& notification, bool skipRemove) {
-	if (!skipRemove) {
-		RemoveNotification(notification.key);
+void NotificationsTabWidget::NotificationList(const Batch<Notification>& list) {
+	m_retryTimer->stop();
+
+	if (m_contentLoaded && !m_contentStale) {
+		return;
 	}
 
-	NotificationWidget* widget = new NotificationWidget(notification, ui->contentScrollWidget);
+	setUpdatesEnabled(false);
 
-	connect(widget,
-			&NotificationWidget::Dismiss,
-			this,
-			&NotificationsTabWidget::DismissNotification);
+	/* The list already holds everything logged so far */
+	m_changeLog.Clear();
 
-	ui->contentScrollLayout->insertWidget(0, widget);
-}
+	if (m_contentStale) {
+		/* Only the rows that changed are touched, the scroll position stays */
+		m_model->Reconcile(list);
 
-void NotificationsTabWidget::RemoveNotification(const QString& key) {
-	QLayoutItem* item;
-	NotificationWidget* widget;
+		m_contentEmpty = m_model->IsEmpty();
+		m_contentStale = false;
 
-	int i = ui->contentScrollLayout->count();
+		UpdateLayout();
+		return;
+	}
 
-	while (--i >= 0) {
-		item = ui->contentScrollLayout->itemAt(i);
+	ClearContent();
 
-		if (item == nullptr || item->widget() == nullptr) {
-			continue;
-		}
+	m_model->Assign(list);
 
-		widget = qobject_cast<NotificationWidget*>(item->widget());
+	m_contentEmpty = m_model->IsEmpty();
+	m_contentLoaded = true;
 
-		if (widget != nullptr && key == widget->GetKey()) {
-			widget->deleteLater();
+	UpdateLayout();
+}
 
-			delete ui->contentScrollLayout->takeAt(i);
+void NotificationsTabWidget::on_dismissAllButton_clicked() {
+	emit DismissNotifications(m_model->GetDismissableKeys());
+}
 
-			break;
-		}
+void NotificationsTabWidget::on_refreshButton_clicked() {
+	setUpdatesEnabled(false);
+
+	if (m_contentLoaded) {
+		m_contentStale = true;
+	} else {
+		ClearContent();
 	}
+
+	UpdateLayout();
+
+	QTimer::singleShot(LOAD_DELAY, this, &NotificationsTabWidget::LoadContent);
 }
 
-void NotificationsTabWidget::NotificationReceived(const Notification& notification) {
-	InsertNotification(notification);
+void NotificationsTabWidget::on_historyButton_clicked() {
+	setUpdatesEnabled(false);
 
-	if (m_contentEmpty) {
-		m_contentEmpty = false;
+	m_historyMode = true;
 
-		UpdateLayout();
-	}
+	ShowSearchResults(ui->searchLineEdit->text());
+
+	UpdateLayout();
 }
 
-void NotificationsTabWidget::NotificationRemoved(const Notification& notification) {
-	RemoveNotification(notification.key);
+void NotificationsTabWidget::on_historyBackButton_clicked() {
+	setUpdatesEnabled(false);
 
-	if (ui->contentScrollLayout->count() <= 1) {
-		m_contentEmpty = true;
+	m_historyMode = false;
 
-		UpdateLayout();
-	}
+	ClearHistory();
+
+	UpdateLayout();
 }
 
-void NotificationsTabWidget::NotificationList(const std::list<Notification>& list) {
-	m_retryTimer->stop();
+void NotificationsTabWidget::on_historyLoadMoreButton_clicked() {
+	LoadHistoryPage();
+}
 
-	if (m_contentLoaded) {
+void NotificationsTabWidget::on_searchLineEdit_FocusReceived(FocusLineEdit* edit) {
+	emit ShowVRKeyboard(KEYBOARD_INPUT_SEARCH,
+						static_cast<uint32_t>(edit->maxLength()),
+						edit->text().toStdString().c_str(),
+						"Search");
+}
+
+void NotificationsTabWidget::on_searchLineEdit_textChanged(const QString& text) {
+	if (!m_historyMode) {
 		return;
 	}
 
 	setUpdatesEnabled(false);
 
-	ClearContent();
+	ShowSearchResults(text);
 
-	auto iterator = list.rbegin();
+	setUpdatesEnabled(true);
+}
 
-	while (iterator != list.rend()) {
-		InsertNotification(*iterator, true);
+void NotificationsTabWidget::LoadHistoryPage() {
+	if (m_history == nullptr || m_historyCursor == 0) {
+		ui->historyLoadMoreButton->setVisible(false);
 
-		m_contentEmpty = false;
+		return;
+	}
+
+	std::vector<NotificationHistory::Entry> entries;
+
+	m_historyCursor = m_history->Read(m_historyCursor, HISTORY_PAGE_SIZE, &entries);
 
-		++iterator;
+	/* Pages are appended above the load more button */
+	int index = ui->historyScrollLayout->indexOf(ui->historyLoadMoreButton);
+
+	for (const NotificationHistory::Entry& entry : entries) {
+		NotificationWidget* widget = new NotificationWidget(entry.notification,
+				entry.date,
+				ui->historyScrollWidget);
+
+		ui->historyScrollLayout->insertWidget(index++, widget);
 	}
 
-	m_contentLoaded = true;
+	ui->historyLoadMoreButton->setVisible(m_historyCursor > 0);
+}
 
-	UpdateLayout();
+void NotificationsTabWidget::ShowSearchResults(const QString& query) {
+	ClearHistory();
+
+	QString trimmed = query.trimmed();
+
+	if (trimmed.isEmpty() || m_searchIndex == nullptr) {
+		m_historyCursor = (m_history != nullptr) ? m_history->Sequence() : 0;
+
+		LoadHistoryPage();
+		return;
+	}
+
+	ui->historyLoadMoreButton->setVisible(false);
+
+	int index = ui->historyScrollLayout->indexOf(ui->historyLoadMoreButton);
+
+	for (const SearchIndex::Document& document : m_searchIndex->Search(trimmed, SEARCH_MAX_RESULTS)) {
+		Notification notification;
+		notification.persistent = true;
+		notification.text = document.text;
+
+		if (document.source == SearchIndex::Source::SMS) {
+			notification.appName = InternedString(QString("SMS"));
+			notification.title = document.title.isEmpty() ? document.origin : document.title;
+		} else {
+			notification.appName = InternedString(document.origin);
+			notification.title = document.title;
+		}
+
+		NotificationWidget* widget = new NotificationWidget(notification,
+				document.date,
+				ui->historyScrollWidget);
+
+		ui->historyScrollLayout->insertWidget(index++, widget);
+	}
 }
 
-void NotificationsTabWidget::on_dismissAllButton_clicked() {
+void NotificationsTabWidget::ClearHistory() {
 	QLayoutItem* item;
-	NotificationWidget* widget;
 
-	int i = ui->contentScrollLayout->count();
+	int i = ui->historyScrollLayout->count();
 
 	while (--i >= 0) {
-		item = ui->contentScrollLayout->itemAt(i);
+		item = ui->historyScrollLayout->itemAt(i);
 
 		if (item == nullptr || item->widget() == nullptr) {
 			continue;
 		}
 
-		widget = qobject_cast<NotificationWidget*>(item->widget());
+		if (qobject_cast<NotificationWidget*>(item->widget()) != nullptr) {
+			item->widget()->deleteLater();
 
-		if (widget != nullptr && !widget->IsPersistent()) {
-			emit DismissNotification(widget->GetKey());
+			delete ui->historyScrollLayout->takeAt(i);
 		}
 	}
-}
 
-void NotificationsTabWidget::on_refreshButton_clicked() {
-	setUpdatesEnabled(false);
+	ui->historyScrollArea->verticalScrollBar()->setValue(0);
 
-	ClearContent();
-
-	UpdateLayout();
-
-	QTimer::singleShot(LOAD_DELAY, this, &NotificationsTabWidget::LoadContent);
+	m_historyCursor = 0;
 }
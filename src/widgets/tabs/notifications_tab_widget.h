@@ -1,8 +1,15 @@
 #pragma once
 
 #include <QWidget>
+#include <QStringList>
 
 #include "../../common.h"
+#include "../../batch.h"
+#include "../../notification_history.h"
+#include "../../notification_change_log.h"
+#include "../../search_index.h"
+#include "../focus_line_edit.h"
+#include "../notification_list_model.h"
 
 #define LOAD_DELAY  500
 
@@ -18,21 +25,41 @@ class NotificationsTabWidget : public QWidget {
 		~NotificationsTabWidget();
 
 		void SetFeatureEnabled(bool enabled);
+		void SetHistory(NotificationHistory* history);
+		void SetSearchIndex(const SearchIndex* searchIndex);
+		void RestoreContent(const Batch<Notification>& list);
 
 	public slots:
 		void CurrentTabChanged(const Tab& tab);
+		void OverlayVisibilityChanged(bool visible);
 		void ServerStateChanged(const ServerState& state);
+		void ExpireContent();
+
+		void VRKeyboardData(uint8_t identifier, const std::string& data);
 
 		void NotificationReceived(const Notification& notification);
 		void NotificationRemoved(const Notification& notification);
-		void NotificationList(const std::list<Notification>& list);
+		void NotificationList(const Batch<Notification>& list);
 
 		void on_dismissAllButton_clicked();
 		void on_refreshButton_clicked();
+		void on_historyButton_clicked();
+		void on_historyBackButton_clicked();
+		void on_historyLoadMoreButton_clicked();
+		void on_searchLineEdit_FocusReceived(FocusLineEdit* edit);
+		void on_searchLineEdit_textChanged(const QString& text);
 
 	signals:
+		void ShowVRKeyboard(uint8_t identifier,
+							uint32_t maxLen,
+							const char* initialText = nullptr,
+							const char* description = nullptr,
+							bool singleLine = true,
+							bool password = false);
+
 		void ListNotifications();
 		void DismissNotification(const QString& key);
+		void DismissNotifications(const QStringList& keys);
 
 	private:
 		Ui::NotificationsTabWidget* ui;
@@ -40,17 +67,33 @@ class NotificationsTabWidget : public QWidget {
 		Tab m_tab;
 		ServerState m_serverState;
 		bool m_featureEnabled;
+		bool m_overlayVisible;
 
 		QTimer* m_retryTimer;
 
 		bool m_contentLoaded;
 		bool m_contentEmpty;
+		bool m_contentStale;
+
+		NotificationListModel* m_model;
+		NotificationChangeLog m_changeLog;
+
+		NotificationHistory* m_history;
+		bool m_historyMode;
+		uint64_t m_historyCursor;
+
+		const SearchIndex* m_searchIndex;
+
+		bool IsShown() const;
+		void ApplyPendingChanges();
 
 		void UpdateLayout();
+		void ShowStaleContent(const QString& status);
 
 		void LoadContent();
 		void ClearContent();
 
-		void InsertNotification(const Notification& notification, bool skipRemove = false);
-		void RemoveNotification(const QString& key);
+		void LoadHistoryPage();
+		void ShowSearchResults(const QString& query);
+		void ClearHistory();
 };
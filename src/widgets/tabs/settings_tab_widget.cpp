@@ -114,7 +114,7 @@ bool SettingsTabWidget::SavePort(const std::string& input) {
 	} catch (const std::exception& ex) {
 		spdlog::warn(ex.what());
 
-		emit ShowVRNotification("invalid_port",
+		emit ShowVRNotification(InternedString(SYSTEM_NOTIFICATION_PREFIX "invalid_port"),
 								"Failed to edit port\nInvalid port",
 								false);
 
@@ -33,7 +33,7 @@ class SettingsTabWidget : public QWidget {
 		void StartServer();
 		void StopServer();
 
-		void ShowVRNotification(const std::string& identifier,
+		void ShowVRNotification(const InternedString& identifier,
 								const std::string& text,
 								bool sound = true,
 								bool persistent = false);
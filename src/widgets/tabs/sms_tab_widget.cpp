@@ -1,13 +1,55 @@
+#include <algorithm>
+
 #include <QTimer>
 #include <QScrollBar>
-#include <QSvgWidget>
-#include <QSvgRenderer>
 
 #include "sms_tab_widget.h"
 #include "ui_sms_tab_widget.h"
 
-#include "../sms_widget.h"
-#include "../short_sms_widget.h"
+#include "../sms_item_delegate.h"
+#include "../loading_spinner.h"
+
+/*
+ * Takes the shown message matching a received one out of the edge
+ *
+ * Dates only go down to the second, the messages of the edge second are
+ * compared as a whole and each one only matches once.
+ */
+
+static bool TakeShown(std::vector<ShortSMS>* edge, const ShortSMS& shortSms) {
+	auto iterator = std::find_if(edge->begin(), edge->end(), [&](const ShortSMS & shown) {
+		return (shown.date == shortSms.date
+				&& shown.incoming == shortSms.incoming
+				&& shown.body == shortSms.body);
+	});
+
+	if (iterator == edge->end()) {
+		return false;
+	}
+
+	edge->erase(iterator);
+
+	return true;
+}
+
+/*
+ * Whether a message is past the shown ones, older or newer than the bound
+ */
+
+static bool IsBeyond(const ShortSMS& shortSms,
+					 const QDateTime& bound,
+					 bool older,
+					 std::vector<ShortSMS>* edge) {
+	if (!bound.isValid()) {
+		return true;
+	}
+
+	if (shortSms.date == bound) {
+		return !TakeShown(edge, shortSms);
+	}
+
+	return older ? (shortSms.date < bound) : (shortSms.date > bound);
+}
 
 SMSTabWidget::SMSTabWidget(QWidget* parent)
 	: QWidget(parent),
@@ -16,20 +58,34 @@ SMSTabWidget::SMSTabWidget(QWidget* parent)
 	  m_serverState(ServerState::NONE),
 	  m_featureEnabled(false),
 	  m_retryTimer(nullptr),
+	  m_prefetchTimer(nullptr),
+	  m_cache(SMS_CACHE_BUDGET),
+	  m_model(nullptr),
+	  m_prefetchGeneration(0),
 	  m_currentNumber(QString()),
 	  m_currentName(QString()),
 	  m_contentLoaded(false),
 	  m_contentEmpty(true),
-	  m_nextPage(0),
-	  m_savedScroll(0) {
+	  m_contentStale(false),
+	  m_contentCached(false),
+	  m_hasOlderPages(false),
+	  m_requestedPage(-1) {
 	ui->setupUi(this);
 
-	QSvgWidget* loader = new QSvgWidget(":/images/loading.svg", this);
-	loader->renderer()->setFramesPerSecond(60);
-	loader->setFixedSize(70, 70);
+	LoadingSpinner* loader = new LoadingSpinner(SPINNER_SIZE, this);
 
 	ui->loadingLayout->insertWidget(0, loader, 0, Qt::AlignHCenter);
 
+	m_model = new SMSListModel(this);
+
+	ui->smsListView->setModel(m_model);
+	ui->smsListView->setItemDelegate(new SMSItemDelegate(this));
+	ui->smsListView->viewport()->setAttribute(Qt::WA_Hover);
+
+	connect(ui->smsListView, &QListView::clicked, this, [&](const QModelIndex & index) {
+		OpenThread(index.data(SMSListModel::NumberRole).toString());
+	});
+
 	m_retryTimer = new QTimer(this);
 
 	connect(m_retryTimer, &QTimer::timeout, this, &SMSTabWidget::LoadContent);
@@ -37,6 +93,25 @@ SMSTabWidget::SMSTabWidget(QWidget* parent)
 	m_retryTimer->setInterval(60000);
 	m_retryTimer->setSingleShot(true);
 
+	m_prefetchTimer = new QTimer(this);
+
+	connect(m_prefetchTimer, &QTimer::timeout, this, &SMSTabWidget::Prefetch);
+
+	m_prefetchTimer->setInterval(SMS_PREFETCH_DELAY);
+	m_prefetchTimer->setSingleShot(true);
+
+	ui->threadView->SetPlaceholder("No SMS");
+
+	connect(ui->threadView->verticalScrollBar(),
+			&QScrollBar::valueChanged,
+			this,
+			&SMSTabWidget::CheckScroll);
+
+	connect(ui->threadView->verticalScrollBar(),
+			&QScrollBar::rangeChanged,
+			this,
+			&SMSTabWidget::CheckScroll);
+
 	ui->statusLabel->setVisible(false);
 	ui->loadingWidget->setVisible(false);
 	ui->contentWidget->setVisible(false);
@@ -50,6 +125,33 @@ void SMSTabWidget::SetFeatureEnabled(bool enabled) {
 	m_featureEnabled = enabled;
 }
 
+const Batch<SMS>& SMSTabWidget::GetSMSList() const {
+	return m_smsList;
+}
+
+std::vector<SMSCache::Thread> SMSTabWidget::GetThreads(int count) const {
+	return m_cache.GetThreads(count);
+}
+
+void SMSTabWidget::RestoreContent(const Batch<SMS>& list,
+								  const std::vector<SMSCache::Thread>& threads) {
+	auto iterator = threads.rbegin();
+
+	while (iterator != threads.rend()) {
+		m_cache.Insert(iterator->number, iterator->name, 0, iterator->list);
+
+		++iterator;
+	}
+
+	SMSList(list);
+
+	if (m_contentLoaded) {
+		m_contentStale = true;
+
+		UpdateLayout();
+	}
+}
+
 void SMSTabWidget::CurrentTabChanged(const Tab& tab) {
 	m_tab = tab;
 
@@ -61,12 +163,22 @@ void SMSTabWidget::CurrentTabChanged(const Tab& tab) {
 void SMSTabWidget::ServerStateChanged(const ServerState& state) {
 	m_serverState = state;
 
+	m_prefetchTimer->stop();
+	m_prefetchQueue.clear();
+
+	/* Replies to earlier prefetches can still come in, they are told apart by generation */
+	++m_prefetchGeneration;
+
 	setUpdatesEnabled(false);
 
-	ClearContent();
+	if (m_contentLoaded) {
+		m_contentStale = true;
+	} else {
+		ClearContent();
 
-	m_currentNumber = QString();
-	m_currentName = QString();
+		m_currentNumber = QString();
+		m_currentName = QString();
+	}
 
 	UpdateLayout();
 
@@ -75,26 +187,22 @@ void SMSTabWidget::ServerStateChanged(const ServerState& state) {
 	}
 }
 
-bool SMSTabWidget::eventFilter(QObject* obj, QEvent* e) {
-	if (e->type() == QEvent::MouseButtonPress) {
-		return true;
-	}
+void SMSTabWidget::ExpireContent() {
+	m_cache.Clear();
+	m_smsList.Clear();
 
-	if (e->type() == QEvent::MouseButtonRelease) {
-		SMSWidget* widget = qobject_cast<SMSWidget*>(obj);
+	if (!m_contentLoaded && !m_contentStale && m_currentNumber.isEmpty()) {
+		return;
+	}
 
-		QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(e);
+	setUpdatesEnabled(false);
 
-		if (widget != nullptr
-				&& mouseEvent->button() == Qt::LeftButton
-				&& widget->rect().contains(mouseEvent->localPos().toPoint())) {
-			OpenThread(widget->GetNumber());
-		}
+	ClearContent();
 
-		return true;
-	}
+	m_currentNumber = QString();
+	m_currentName = QString();
 
-	return QWidget::eventFilter(obj, e);
+	UpdateLayout();
 }
 
 void SMSTabWidget::UpdateLayout() {
@@ -110,6 +218,11 @@ void SMSTabWidget::UpdateLayout() {
 			break;
 
 		case ServerState::STARTED:
+			if (m_contentStale) {
+				ShowStaleContent("Reconnecting…");
+				break;
+			}
+
 			ui->loadingWidget->setVisible(false);
 			ui->contentWidget->setVisible(false);
 
@@ -124,6 +237,8 @@ void SMSTabWidget::UpdateLayout() {
 
 				ui->statusLabel->setText("Feature disabled");
 				ui->statusLabel->setVisible(true);
+			} else if (m_contentStale) {
+				ShowStaleContent("Refreshing…");
 			} else if (!m_contentLoaded) {
 				ui->statusLabel->setVisible(false);
 				ui->contentWidget->setVisible(false);
@@ -139,44 +254,62 @@ void SMSTabWidget::UpdateLayout() {
 				ui->statusLabel->setVisible(false);
 				ui->loadingWidget->setVisible(false);
 
-				if (m_currentNumber.isEmpty()) {
-					ui->backButton->setVisible(false);
-					ui->titleLabel->setVisible(false);
+				ShowContent(true);
+			}
 
-					ui->loadMoreButton->setVisible(false);
+			break;
 
-					ui->inputWidget->setVisible(false);
+		default:
+			break;
+	}
 
-					ui->contentWidget->setVisible(true);
-				} else {
-					ui->backButton->setVisible(true);
+	setUpdatesEnabled(true);
+}
 
-					ui->titleLabel->setText(m_currentName.isEmpty()
-											? m_currentNumber
-											: m_currentName);
-					ui->titleLabel->setVisible(true);
+void SMSTabWidget::ShowContent(bool enabled) {
+	if (m_currentNumber.isEmpty()) {
+		ui->backButton->setVisible(false);
+		ui->titleLabel->setVisible(false);
 
-					ui->loadMoreButton->setVisible(m_nextPage > 0);
+		ui->threadView->setVisible(false);
+		ui->smsListView->setVisible(true);
 
-					ui->inputWidget->setVisible(true);
+		ui->inputWidget->setVisible(false);
+	} else {
+		ui->backButton->setVisible(true);
 
-					ui->contentWidget->setVisible(true);
-				}
-			}
+		ui->smsListView->setVisible(false);
+		ui->threadView->setVisible(true);
 
-			break;
+		ui->titleLabel->setText(m_currentName.isEmpty()
+								? m_currentNumber
+								: m_currentName);
+		ui->titleLabel->setVisible(true);
 
-		default:
-			break;
+		ui->inputWidget->setVisible(true);
 	}
 
-	setUpdatesEnabled(true);
+	ui->contentWidget->setEnabled(enabled);
+	ui->contentWidget->setVisible(true);
+}
+
+void SMSTabWidget::ShowStaleContent(const QString& status) {
+	ui->loadingWidget->setVisible(false);
+
+	ui->statusLabel->setText("<font color='#999'>" + status + "</font>");
+	ui->statusLabel->setVisible(true);
+
+	if (m_contentEmpty) {
+		ui->contentWidget->setVisible(false);
+	} else {
+		ShowContent(false);
+	}
 }
 
 void SMSTabWidget::LoadContent() {
 	m_retryTimer->stop();
 
-	if (m_contentLoaded
+	if ((m_contentLoaded && !m_contentStale && !m_contentCached)
 			|| m_tab != Tab::SMS
 			|| m_serverState != ServerState::CONNECTED) {
 		return;
@@ -185,6 +318,9 @@ void SMSTabWidget::LoadContent() {
 	if (m_currentNumber.isEmpty()) {
 		emit ListSMS();
 	} else {
+		/* Whatever reply comes for it now answers this request */
+		m_prefetchNumbers.remove(m_currentNumber);
+
 		emit ListSMSFrom(m_currentNumber, 0);
 	}
 
@@ -192,65 +328,116 @@ void SMSTabWidget::LoadContent() {
 }
 
 void SMSTabWidget::ClearContent() {
-	QLayoutItem* item;
+	ui->threadView->Clear();
 
-	int i = ui->contentScrollLayout->count();
+	m_model->Clear();
 
-	while (--i >= 1) {
-		item = ui->contentScrollLayout->itemAt(i);
+	ui->inputTextEdit->setPlainText("");
 
-		if (item == nullptr) {
-			ui->contentScrollLayout->takeAt(i);
+	m_pending.clear();
 
-			continue;
-		}
+	m_contentLoaded = false;
+	m_contentEmpty = true;
+	m_contentStale = false;
+	m_contentCached = false;
 
-		if (item->spacerItem() != nullptr) {
-			continue;
-		}
+	m_threadPages.clear();
+	m_hasOlderPages = false;
+	m_requestedPage = -1;
+}
+
+void SMSTabWidget::RefreshThread(const Batch<ShortSMS>& list) {
+	QDateTime newest = NewestDate();
+	std::vector<ShortSMS> edge = NewestEdge();
+
+	auto iterator = list.rbegin();
 
-		if (item->widget() != nullptr) {
-			item->widget()->deleteLater();
+	while (iterator != list.rend()) {
+		if (IsBeyond(*iterator, newest, false, &edge)) {
+			AppendShortSMS(*iterator);
 		}
 
-		if (item->layout() != nullptr) {
-			item->layout()->deleteLater();
+		++iterator;
+	}
+}
+
+void SMSTabWidget::UpdateSMSList(const SMS& sms) {
+	Batch<SMS> list;
+
+	list.Reserve(m_smsList.Size() + 1);
+	list.Append(sms);
+
+	for (const SMS& entry : m_smsList) {
+		if (entry.number != sms.number) {
+			list.Append(entry);
 		}
+	}
 
-		delete ui->contentScrollLayout->takeAt(i);
+	m_smsList = std::move(list);
+}
+
+quint64 SMSTabWidget::AppendShortSMS(const ShortSMS& shortSms, const ThreadView::State& state) {
+	if (m_currentNumber.isEmpty()) {
+		return 0;
 	}
 
-	ui->inputTextEdit->setPlainText("");
+	/* Live messages belong to page 0 and are evicted with it */
+	if (m_threadPages.empty()) {
+		ThreadPage threadPage;
+		threadPage.page = 0;
+		threadPage.count = 0;
 
-	m_contentLoaded = false;
-	m_contentEmpty = true;
-	m_nextPage = 0;
+		m_threadPages.push_back(threadPage);
+	}
+
+	++m_threadPages.back().count;
+
+	UpdateNewestDate(shortSms);
+
+	return ui->threadView->Append(shortSms, state);
 }
 
-void SMSTabWidget::InsertSMS(const SMS& sms) {
-	if (!m_currentNumber.isEmpty()) {
+void SMSTabWidget::UpdateNewestDate(const ShortSMS& shortSms) {
+	if (!shortSms.date.isValid() || m_threadPages.empty()) {
 		return;
 	}
 
-	SMSWidget* widget = new SMSWidget(sms, ui->contentScrollWidget);
+	ThreadPage& threadPage = m_threadPages.back();
+
+	if (!threadPage.oldest.isValid() || shortSms.date < threadPage.oldest) {
+		threadPage.oldest = shortSms.date;
+		threadPage.oldestEdge.clear();
+	}
+
+	if (shortSms.date == threadPage.oldest) {
+		threadPage.oldestEdge.push_back(shortSms);
+	}
 
-	widget->installEventFilter(this);
+	if (!threadPage.newest.isValid() || shortSms.date > threadPage.newest) {
+		threadPage.newest = shortSms.date;
+		threadPage.newestEdge.clear();
+	}
 
-	ui->contentScrollLayout->insertWidget(1, widget);
+	if (shortSms.date == threadPage.newest) {
+		threadPage.newestEdge.push_back(shortSms);
+	}
 }
 
-void SMSTabWidget::InsertShortSMS(const ShortSMS& shortSms) {
-	if (m_currentNumber.isEmpty()) {
+void SMSTabWidget::ExpirePending(quint64 identifier) {
+	auto iterator = m_pending.begin();
+
+	while (iterator != m_pending.end() && iterator->identifier != identifier) {
+		++iterator;
+	}
+
+	if (iterator == m_pending.end()) {
 		return;
 	}
 
-	ShortSMSWidget* widget = new ShortSMSWidget(shortSms, ui->contentScrollWidget);
+	/* No confirmation, the phone may never have got it */
+	ui->threadView->SetState(identifier, ThreadView::State::FAILED);
 
-	if (shortSms.incoming) {
-		ui->contentScrollLayout->insertWidget(2, widget, 0, Qt::AlignLeft);
-	} else {
-		ui->contentScrollLayout->insertWidget(2, widget, 0, Qt::AlignRight);
-	}
+	m_pending.erase(iterator);
 }
 
 void SMSTabWidget::VRKeyboardData(uint8_t identifier, const std::string& data) {
@@ -269,138 +456,497 @@ void SMSTabWidget::VRKeyboardData(uint8_t identifier, const std::string& data) {
 	}
 }
 
-void SMSTabWidget::SMSList(const std::list<SMS>& list) {
+void SMSTabWidget::SMSList(const Batch<SMS>& list) {
 	m_retryTimer->stop();
 
-	if (m_contentLoaded) {
+	if (m_contentLoaded && !m_contentStale) {
 		return;
 	}
 
 	setUpdatesEnabled(false);
 
-	ClearContent();
+	m_smsList = list.Share();
 
-	m_currentNumber = QString();
-	m_currentName = QString();
-
-	auto iterator = list.rbegin();
+	if (m_contentStale && m_currentNumber.isEmpty() && !m_model->IsEmpty()) {
+		/* Only the conversations that changed are touched, the scroll position stays */
+		m_model->Reconcile(list);
 
-	while (iterator != list.rend()) {
-		InsertSMS(*iterator);
+		m_contentEmpty = m_model->IsEmpty();
+		m_contentStale = false;
 
-		m_contentEmpty = false;
+		UpdateLayout();
 
-		++iterator;
+		QueuePrefetch(list);
+		return;
 	}
 
+	ClearContent();
+
+	m_currentNumber = QString();
+	m_currentName = QString();
+
+	m_model->Assign(list);
+
+	m_contentEmpty = m_model->IsEmpty();
 	m_contentLoaded = true;
 
 	UpdateLayout();
 
-	ui->contentScrollArea->verticalScrollBar()->setValue(0);
+	ui->smsListView->scrollToTop();
+
+	QueuePrefetch(list);
 }
 
 void SMSTabWidget::SMSFromList(const QString& number,
 							   const QString& name,
 							   int page,
-							   const std::list<ShortSMS>& list) {
-	m_retryTimer->stop();
+							   const Batch<ShortSMS>& list) {
+	auto prefetch = (page == 0) ? m_prefetchNumbers.find(number) : m_prefetchNumbers.end();
+
+	bool prefetched = (prefetch != m_prefetchNumbers.end());
+
+	if (prefetched) {
+		int generation = prefetch.value();
 
-	if (page <= 0) {
-		if (m_contentLoaded) {
+		m_prefetchNumbers.erase(prefetch);
+
+		if (generation != m_prefetchGeneration) {
+			/* Requested over another connection, nothing waits on it */
 			return;
 		}
+	}
+
+	m_cache.Insert(number, name, page, list);
+
+	if (prefetched && number != m_currentNumber) {
+		return;
+	}
+
+	m_retryTimer->stop();
+
+	ShowPage(number, name, page, list);
+}
+
+void SMSTabWidget::ShowPage(const QString& number,
+							const QString& name,
+							int page,
+							const Batch<ShortSMS>& list) {
+	if (page >= 0 && page == m_requestedPage && number == m_currentNumber) {
+		m_requestedPage = -1;
+
+		/* Nothing to line up with once the pages are cleared, it starts over */
+		bool older = (!m_threadPages.empty() && page > m_threadPages.front().page);
 
 		setUpdatesEnabled(false);
 
-		ClearContent();
+		AddPage(page, list, older);
 
-		page = 0;
-	} else if (page != m_nextPage) {
+		setUpdatesEnabled(true);
 		return;
-	} else {
-		setUpdatesEnabled(false);
 	}
 
-	m_contentEmpty = true;
+	if (page != 0) {
+		return;
+	}
+
+	if (m_contentLoaded && !m_contentStale && !m_contentCached) {
+		return;
+	}
+
+	setUpdatesEnabled(false);
+
+	if ((m_contentStale || m_contentCached)
+			&& number == m_currentNumber
+			&& NewestDate().isValid()) {
+		if (IsAtNewest()) {
+			RefreshThread(list);
+		}
+
+		m_requestedPage = -1;
+
+		m_contentStale = false;
+		m_contentCached = false;
+
+		UpdateLayout();
+		return;
+	}
+
+	ClearContent();
 
 	m_currentNumber = number;
 	m_currentName = name;
 
-	m_savedScroll = ui->contentScrollArea->verticalScrollBar()->maximum()
-					- ui->contentScrollArea->verticalScrollBar()->value();
+	if (!list.IsEmpty()) {
+		AddPage(0, list, true);
+	}
 
-	auto iterator = list.begin();
+	m_contentEmpty = false;
+	m_contentLoaded = true;
 
-	while (iterator != list.end()) {
-		InsertShortSMS(*iterator);
+	UpdateLayout();
 
-		m_contentEmpty = false;
+	ui->threadView->ScrollToBottom();
+}
+
+void SMSTabWidget::AddPage(int page, const Batch<ShortSMS>& list, bool older) {
+	if (older && list.IsEmpty()) {
+		m_hasOlderPages = false;
+		return;
+	}
+
+	/* The view keeps the messages on screen in place */
+	while (static_cast<int>(m_threadPages.size()) >= SMS_MAX_LOADED_PAGES) {
+		EvictPage(!older);
+	}
+
+	QDateTime bound = older ? OldestDate() : NewestDate();
+	std::vector<ShortSMS> edge = older ? OldestEdge() : NewestEdge();
+
+	ThreadPage threadPage;
+	threadPage.page = page;
+
+	std::vector<ShortSMS> messages;
+
+	messages.reserve(static_cast<size_t>(list.Size()));
+
+	/* Pages shift by one with every new message, what is already shown is dropped */
+	auto iterator = list.rbegin();
+
+	while (iterator != list.rend()) {
+		if (IsBeyond(*iterator, bound, older, &edge)) {
+			messages.push_back(*iterator);
+
+			if (!threadPage.oldest.isValid() || iterator->date < threadPage.oldest) {
+				threadPage.oldest = iterator->date;
+			}
+
+			if (!threadPage.newest.isValid() || iterator->date > threadPage.newest) {
+				threadPage.newest = iterator->date;
+			}
+		}
 
 		++iterator;
 	}
 
-	if (m_contentEmpty) {
-		if (page == 0) {
-			QLabel* emptyLabel = new QLabel("No SMS", ui->contentScrollWidget);
+	for (const ShortSMS& shortSms : messages) {
+		if (shortSms.date == threadPage.oldest) {
+			threadPage.oldestEdge.push_back(shortSms);
+		}
 
-			ui->contentScrollLayout->insertWidget(1, emptyLabel, 1, Qt::AlignHCenter);
+		if (shortSms.date == threadPage.newest) {
+			threadPage.newestEdge.push_back(shortSms);
 		}
+	}
+
+	threadPage.count = static_cast<int>(messages.size());
+
+	if (older) {
+		ui->threadView->PrependPage(messages);
+
+		m_threadPages.push_front(threadPage);
 
-		m_nextPage = 0;
+		m_hasOlderPages = true;
 	} else {
-		m_nextPage = page + 1;
+		ui->threadView->AppendPage(messages);
+
+		m_threadPages.push_back(threadPage);
 	}
+}
 
-	m_contentEmpty = false;
-	m_contentLoaded = true;
+void SMSTabWidget::EvictPage(bool older) {
+	if (older) {
+		ui->threadView->RemoveFirst(m_threadPages.front().count);
+
+		m_threadPages.pop_front();
+
+		m_hasOlderPages = true;
+	} else {
+		ui->threadView->RemoveLast(m_threadPages.back().count);
 
-	if (m_nextPage == 1) {
-		m_savedScroll = 0;
-	} else if (m_nextPage < 1) {
-		m_savedScroll = -1;
+		m_threadPages.pop_back();
 	}
+}
+
+void SMSTabWidget::RequestPage(int page) {
+	m_requestedPage = page;
 
-	if (m_nextPage > SMS_MAX_PAGE) {
-		m_nextPage = 0;
+	QString name;
+	Batch<ShortSMS> list;
+
+	if (m_cache.Find(m_currentNumber, page, &name, &list)) {
+		ShowPage(m_currentNumber, name, page, list);
+		return;
 	}
 
-	UpdateLayout();
+	emit ListSMSFrom(m_currentNumber, page);
+}
 
-	if (m_savedScroll >= 0) {
-		QTimer::singleShot(5, this, [&]() {
-			ui->contentScrollArea->verticalScrollBar()->setValue(
-					ui->contentScrollArea->verticalScrollBar()->maximum() - m_savedScroll);
-		});
+bool SMSTabWidget::IsAtNewest() const {
+	return (m_threadPages.empty() || m_threadPages.back().page == 0);
+}
+
+QDateTime SMSTabWidget::OldestDate() const {
+	auto iterator = m_threadPages.begin();
+
+	while (iterator != m_threadPages.end()) {
+		if (iterator->oldest.isValid()) {
+			return iterator->oldest;
+		}
+
+		++iterator;
 	}
+
+	return QDateTime();
 }
 
-void SMSTabWidget::SMSSent(const QString& number, bool success) {
-	if (!m_contentLoaded || m_currentNumber.isEmpty()) {
+QDateTime SMSTabWidget::NewestDate() const {
+	auto iterator = m_threadPages.rbegin();
+
+	while (iterator != m_threadPages.rend()) {
+		if (iterator->newest.isValid()) {
+			return iterator->newest;
+		}
+
+		++iterator;
+	}
+
+	return QDateTime();
+}
+
+std::vector<ShortSMS> SMSTabWidget::OldestEdge() const {
+	QDateTime oldest = OldestDate();
+
+	std::vector<ShortSMS> edge;
+
+	/* A second can be split across pages */
+	for (const ThreadPage& threadPage : m_threadPages) {
+		if (threadPage.oldest.isValid() && threadPage.oldest != oldest) {
+			break;
+		}
+
+		edge.insert(edge.end(), threadPage.oldestEdge.begin(), threadPage.oldestEdge.end());
+	}
+
+	return edge;
+}
+
+std::vector<ShortSMS> SMSTabWidget::NewestEdge() const {
+	QDateTime newest = NewestDate();
+
+	std::vector<ShortSMS> edge;
+
+	auto iterator = m_threadPages.rbegin();
+
+	while (iterator != m_threadPages.rend()
+			&& (!iterator->newest.isValid() || iterator->newest == newest)) {
+		edge.insert(edge.end(), iterator->newestEdge.begin(), iterator->newestEdge.end());
+
+		++iterator;
+	}
+
+	return edge;
+}
+
+bool SMSTabWidget::IsNewest(const ShortSMS& shortSms) const {
+	std::vector<ShortSMS> edge = NewestEdge();
+
+	return IsBeyond(shortSms, NewestDate(), false, &edge);
+}
+
+void SMSTabWidget::CheckScroll() {
+	if (m_currentNumber.isEmpty()
+			|| m_threadPages.empty()
+			|| m_requestedPage >= 0
+			|| !m_contentLoaded
+			|| m_contentStale
+			|| m_contentCached
+			|| m_serverState != ServerState::CONNECTED) {
 		return;
 	}
 
-	if (m_currentNumber == number && success) {
-		ClearContent();
+	ThreadView* view = ui->threadView;
 
-		UpdateLayout();
+	int top = view->verticalScrollBar()->value();
+	int bottom = top + view->viewport()->height();
 
-		QTimer::singleShot(LOAD_DELAY, this, &SMSTabWidget::LoadContent);
+	if (m_hasOlderPages) {
+		/* Requested while a few bubbles of the oldest page are still ahead */
+		int count = m_threadPages.front().count;
+
+		int limit = (count > 0) ? view->BubbleBottom(std::min(SMS_PREFETCH_BUBBLES, count) - 1) : 0;
+
+		if (top <= limit) {
+			RequestPage(m_threadPages.front().page + 1);
+			return;
+		}
+	}
+
+	if (!IsAtNewest() && view->Count() > 0) {
+		int count = m_threadPages.back().count;
+
+		int limit = (count > 0)
+					? view->BubbleTop(view->Count() - std::min(SMS_PREFETCH_BUBBLES, count))
+					: view->BubbleBottom(view->Count() - 1);
+
+		if (bottom >= limit) {
+			RequestPage(m_threadPages.back().page - 1);
+		}
 	}
 }
 
+void SMSTabWidget::SMSSent(const QString& number, bool success, const ShortSMS& shortSms) {
+	if (success) {
+		if (shortSms.date.isValid()) {
+			m_cache.Prepend(number, shortSms);
+		} else {
+			m_cache.Invalidate(number);
+		}
+	}
+
+	if (!m_contentLoaded || m_currentNumber != number) {
+		return;
+	}
+
+	/* Confirms the local echo with the same body, no reply carries a request id */
+	auto iterator = m_pending.begin();
+
+	while (iterator != m_pending.end() && iterator->body != shortSms.body) {
+		++iterator;
+	}
+
+	if (iterator != m_pending.end()) {
+		ui->threadView->SetState(iterator->identifier,
+								 success
+								 ? ThreadView::State::SENT
+								 : ThreadView::State::FAILED);
+
+		m_pending.erase(iterator);
+
+		/* The echo was added without a date, it now has the one of the phone */
+		if (success) {
+			UpdateNewestDate(shortSms);
+		}
+
+		return;
+	}
+
+	/* Sent from elsewhere while the thread is open */
+	if (success
+			&& shortSms.date.isValid()
+			&& !m_contentStale
+			&& !m_contentCached
+			&& IsAtNewest()
+			&& IsNewest(shortSms)) {
+		AppendShortSMS(shortSms);
+
+		ui->threadView->ScrollToBottom();
+	}
+}
+
+void SMSTabWidget::SMSReceived(const SMS& sms) {
+	ShortSMS shortSms = {sms.incoming, sms.date, sms.body};
+
+	m_cache.Prepend(sms.number.String(), shortSms);
+
+	if (!m_smsList.IsEmpty()) {
+		UpdateSMSList(sms);
+	}
+
+	/* A stale or loading view gets the message with its next list */
+	if (!m_contentLoaded || m_contentStale || m_contentCached) {
+		return;
+	}
+
+	setUpdatesEnabled(false);
+
+	if (m_currentNumber.isEmpty()) {
+		m_model->MoveToTop(sms);
+
+		if (m_contentEmpty) {
+			m_contentEmpty = false;
+
+			UpdateLayout();
+		}
+	} else if (m_currentNumber == sms.number.String()
+			   && IsAtNewest()
+			   && IsNewest(shortSms)) {
+		/* Followed only when the view is at the bottom */
+		AppendShortSMS(shortSms);
+	}
+
+	setUpdatesEnabled(true);
+}
+
 void SMSTabWidget::OpenThread(const QString& number) {
+	ShowThread(number);
+}
+
+void SMSTabWidget::ShowThread(const QString& number) {
 	setUpdatesEnabled(false);
 
 	ClearContent();
 
 	m_currentNumber = number;
 
-	UpdateLayout();
+	QString name;
+	Batch<ShortSMS> list;
+
+	if (m_cache.Find(number, 0, &name, &list)) {
+		/* Shown right away, page 0 is then refreshed in the background */
+		ShowPage(number, name, 0, list);
+
+		m_contentCached = true;
+	} else {
+		UpdateLayout();
+	}
 
 	QTimer::singleShot(LOAD_DELAY, this, &SMSTabWidget::LoadContent);
 }
 
+void SMSTabWidget::QueuePrefetch(const Batch<SMS>& list) {
+	m_prefetchQueue.clear();
+
+	auto iterator = list.begin();
+
+	while (iterator != list.end() && m_prefetchQueue.size() < SMS_PREFETCH_THREADS) {
+		m_prefetchQueue.append(iterator->number.String());
+
+		++iterator;
+	}
+
+	if (!m_prefetchQueue.isEmpty()) {
+		m_prefetchTimer->start();
+	}
+}
+
+void SMSTabWidget::Prefetch() {
+	if (m_serverState != ServerState::CONNECTED) {
+		m_prefetchQueue.clear();
+		return;
+	}
+
+	/* Wait for anything the user is waiting on */
+	if (!m_contentLoaded || m_contentStale || m_contentCached) {
+		m_prefetchTimer->start();
+		return;
+	}
+
+	while (!m_prefetchQueue.isEmpty()) {
+		QString number = m_prefetchQueue.takeFirst();
+
+		if (!m_cache.Contains(number, 0)) {
+			m_prefetchNumbers.insert(number, m_prefetchGeneration);
+
+			emit ListSMSFrom(number, 0);
+			break;
+		}
+	}
+
+	if (!m_prefetchQueue.isEmpty()) {
+		m_prefetchTimer->start();
+	}
+}
+
 void SMSTabWidget::on_backButton_clicked() {
 	setUpdatesEnabled(false);
 
@@ -417,21 +963,24 @@ void SMSTabWidget::on_backButton_clicked() {
 void SMSTabWidget::on_refreshButton_clicked() {
 	setUpdatesEnabled(false);
 
-	ClearContent();
-
-	UpdateLayout();
+	if (m_currentNumber.isEmpty()) {
+		m_cache.Clear();
 
-	QTimer::singleShot(LOAD_DELAY, this, &SMSTabWidget::LoadContent);
-}
+		/* The list stays up until the new one is merged in */
+		if (m_contentLoaded && !m_contentEmpty) {
+			m_contentStale = true;
+		} else {
+			ClearContent();
+		}
+	} else {
+		m_cache.Invalidate(m_currentNumber);
 
-void SMSTabWidget::on_loadMoreButton_clicked() {
-	if (!m_contentLoaded || m_contentEmpty || m_currentNumber.isEmpty()) {
-		return;
+		ClearContent();
 	}
 
-	if (m_nextPage > 0) {
-		emit ListSMSFrom(m_currentNumber, m_nextPage);
-	}
+	UpdateLayout();
+
+	QTimer::singleShot(LOAD_DELAY, this, &SMSTabWidget::LoadContent);
 }
 
 void SMSTabWidget::on_inputTextEdit_FocusReceived(FocusPlainTextEdit* edit) {
@@ -458,5 +1007,27 @@ void SMSTabWidget::on_sendButton_clicked() {
 		ui->inputTextEdit->setPlainText("");
 
 		emit SendSMS(m_currentNumber, body);
+
+		if (!IsAtNewest()) {
+			return;
+		}
+
+		/* Shown right away, without a date until the phone confirms it */
+		ShortSMS shortSms = {false, QDateTime(), body};
+
+		PendingSMS pending;
+		pending.identifier = AppendShortSMS(shortSms, ThreadView::State::PENDING);
+		pending.body = body;
+
+		m_pending.append(pending);
+
+		/* A failure reply without the message cannot be matched */
+		quint64 identifier = pending.identifier;
+
+		QTimer::singleShot(SMS_SEND_TIMEOUT, this, [this, identifier]() {
+			ExpirePending(identifier);
+		});
+
+		ui->threadView->ScrollToBottom();
 	}
 }
@@ -1,9 +1,19 @@
 #pragma once
 
+#include <deque>
+#include <vector>
+
+#include <QHash>
+#include <QList>
 #include <QWidget>
+#include <QStringList>
 
 #include "../../common.h"
+#include "../../batch.h"
+#include "../../sms_cache.h"
 #include "../focus_plain_text_edit.h"
+#include "../sms_list_model.h"
+#include "../thread_view.h"
 
 #define LOAD_DELAY  500
 
@@ -20,30 +30,32 @@ class SMSTabWidget : public QWidget {
 
 		void SetFeatureEnabled(bool enabled);
 
+		const Batch<SMS>& GetSMSList() const;
+		std::vector<SMSCache::Thread> GetThreads(int count) const;
+		void RestoreContent(const Batch<SMS>& list, const std::vector<SMSCache::Thread>& threads);
+
 	public slots:
 		void CurrentTabChanged(const Tab& tab);
 		void ServerStateChanged(const ServerState& state);
+		void ExpireContent();
 
 		void VRKeyboardData(uint8_t identifier, const std::string& data);
 
-		void SMSList(const std::list<SMS>& list);
+		void SMSList(const Batch<SMS>& list);
 		void SMSFromList(const QString& number,
 						 const QString& name,
 						 int page,
-						 const std::list<ShortSMS>& list);
-		void SMSSent(const QString& number, bool success);
+						 const Batch<ShortSMS>& list);
+		void SMSSent(const QString& number, bool success, const ShortSMS& shortSms);
+		void SMSReceived(const SMS& sms);
 
 		void OpenThread(const QString& number);
 
 		void on_backButton_clicked();
 		void on_refreshButton_clicked();
-		void on_loadMoreButton_clicked();
 		void on_inputTextEdit_FocusReceived(FocusPlainTextEdit* edit);
 		void on_sendButton_clicked();
 
-	protected:
-		bool eventFilter(QObject* obj, QEvent* e) override;
-
 	signals:
 		void ShowVRKeyboard(uint8_t identifier,
 							uint32_t maxLen,
@@ -64,19 +76,77 @@ class SMSTabWidget : public QWidget {
 		bool m_featureEnabled;
 
 		QTimer* m_retryTimer;
+		QTimer* m_prefetchTimer;
+
+		SMSCache m_cache;
+		Batch<SMS> m_smsList;
+		SMSListModel* m_model;
+		QStringList m_prefetchQueue;
+		/* Prefetched numbers and the connection generation they were requested in */
+		QHash<QString, int> m_prefetchNumbers;
+		int m_prefetchGeneration;
+
+		struct PendingSMS {
+			quint64 identifier;
+			QString body;
+		};
+
+		/* Sent from this thread, waiting for sms_sent or the timeout, oldest first */
+		QList<PendingSMS> m_pending;
 
 		QString m_currentNumber;
 		QString m_currentName;
 		bool m_contentLoaded;
 		bool m_contentEmpty;
-		int m_nextPage;
-		int m_savedScroll;
+		bool m_contentStale;
+		bool m_contentCached;
+
+		struct ThreadPage {
+			int page;
+			int count;
+			QDateTime oldest;
+			QDateTime newest;
+			/* Messages at the oldest and newest second, dates alone cannot tell them apart */
+			std::vector<ShortSMS> oldestEdge;
+			std::vector<ShortSMS> newestEdge;
+		};
+
+		/* Pages of the open thread in the view, oldest first */
+		std::deque<ThreadPage> m_threadPages;
+		bool m_hasOlderPages;
+		int m_requestedPage;
 
 		void UpdateLayout();
+		void ShowContent(bool enabled);
+		void ShowStaleContent(const QString& status);
 
 		void LoadContent();
 		void ClearContent();
-
-		void InsertSMS(const SMS& sms);
-		void InsertShortSMS(const ShortSMS& shortSms);
+		void ShowThread(const QString& number);
+		void ShowPage(const QString& number,
+					  const QString& name,
+					  int page,
+					  const Batch<ShortSMS>& list);
+		void RefreshThread(const Batch<ShortSMS>& list);
+
+		void AddPage(int page, const Batch<ShortSMS>& list, bool older);
+		void EvictPage(bool older);
+		void RequestPage(int page);
+		bool IsAtNewest() const;
+		QDateTime OldestDate() const;
+		QDateTime NewestDate() const;
+		std::vector<ShortSMS> OldestEdge() const;
+		std::vector<ShortSMS> NewestEdge() const;
+		bool IsNewest(const ShortSMS& shortSms) const;
+
+		void CheckScroll();
+
+		void QueuePrefetch(const Batch<SMS>& list);
+		void Prefetch();
+
+		void UpdateSMSList(const SMS& sms);
+		void UpdateNewestDate(const ShortSMS& shortSms);
+		void ExpirePending(quint64 identifier);
+		quint64 AppendShortSMS(const ShortSMS& shortSms,
+							   const ThreadView::State& state = ThreadView::State::SENT);
 };
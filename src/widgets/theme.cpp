@@ -0,0 +1,47 @@
+#include "theme.h"
+
+#define THEME_FONT_FAMILY   "Calibri"
+
+Theme::Theme()
+	: itemMargin(11),
+	  itemSpacing(15),
+	  card("#163e65"),
+	  cardStack("#123252"),
+	  item("#184978"),
+	  itemHover("#1e537e"),
+	  bubbleIncoming("#2a4967"),
+	  bubbleOutgoing("#163e65"),
+	  bubblePending("#123252"),
+	  bubbleFailed("#5a2a2a"),
+	  appNameColor("#aaa"),
+	  titleColor("#ddd"),
+	  textColor("#999"),
+	  previewColor("#bbb"),
+	  incomingColor("#ccc"),
+	  dimColor("#888"),
+	  dimHoverColor("#aaa"),
+	  disabledColor("#777"),
+	  appNameFont(MakeFont(16)),
+	  titleFont(MakeFont(20)),
+	  textFont(MakeFont(18)),
+	  dateFont(MakeFont(16)),
+	  smallFont(MakeFont(14)),
+	  appNameMetrics(appNameFont),
+	  titleMetrics(titleFont),
+	  textMetrics(textFont),
+	  dateMetrics(dateFont),
+	  smallMetrics(smallFont) {
+}
+
+const Theme& Theme::Get() {
+	static const Theme theme;
+
+	return theme;
+}
+
+QFont Theme::MakeFont(int pointSize) {
+	QFont font(THEME_FONT_FAMILY);
+	font.setPointSize(pointSize);
+
+	return font;
+}
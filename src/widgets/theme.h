@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QFont>
+#include <QColor>
+#include <QFontMetrics>
+
+/*
+ * Colors, fonts and metrics of the items painted by hand
+ *
+ * Resolved once and shared, list items never go through the stylesheet.
+ * The QSS only styles the static chrome around them.
+ */
+
+class Theme {
+	public:
+		static const Theme& Get();
+
+		/* Metrics */
+		const int itemMargin;
+		const int itemSpacing;
+
+		/* Backgrounds */
+		const QColor card;
+		const QColor cardStack;
+		const QColor item;
+		const QColor itemHover;
+		const QColor bubbleIncoming;
+		const QColor bubbleOutgoing;
+		const QColor bubblePending;
+		const QColor bubbleFailed;
+
+		/* Text */
+		const QColor appNameColor;
+		const QColor titleColor;
+		const QColor textColor;
+		const QColor previewColor;
+		const QColor incomingColor;
+		const QColor dimColor;
+		const QColor dimHoverColor;
+		const QColor disabledColor;
+
+		/* Fonts, 14pt for dismiss, dates and statuses */
+		const QFont appNameFont;
+		const QFont titleFont;
+		const QFont textFont;
+		const QFont dateFont;
+		const QFont smallFont;
+
+		const QFontMetrics appNameMetrics;
+		const QFontMetrics titleMetrics;
+		const QFontMetrics textMetrics;
+		const QFontMetrics dateMetrics;
+		const QFontMetrics smallMetrics;
+
+	private:
+		Theme();
+
+		static QFont MakeFont(int pointSize);
+};
@@ -0,0 +1,391 @@
+#include <cmath>
+#include <algorithm>
+
+#include <QEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QPaintEvent>
+
+#include "thread_view.h"
+#include "theme.h"
+
+#define BUBBLE_MAX_TEXT_WIDTH   500
+#define SCROLL_STEP             30
+
+ThreadView::ThreadView(QWidget* parent)
+	: QAbstractScrollArea(parent),
+	  m_nextIdentifier(1),
+	  m_textWidth(BUBBLE_MAX_TEXT_WIDTH),
+	  m_contentHeight(0) {
+	viewport()->setAutoFillBackground(false);
+
+	verticalScrollBar()->setSingleStep(SCROLL_STEP);
+}
+
+void ThreadView::SetPlaceholder(const QString& text) {
+	m_placeholder = text;
+
+	viewport()->update();
+}
+
+int ThreadView::Count() const {
+	return static_cast<int>(m_bubbles.size());
+}
+
+int ThreadView::BubbleTop(int index) const {
+	return m_bubbles[static_cast<size_t>(index)].top + ContentOffset();
+}
+
+int ThreadView::BubbleBottom(int index) const {
+	const Bubble& bubble = m_bubbles[static_cast<size_t>(index)];
+
+	return bubble.top + bubble.size.height() + ContentOffset();
+}
+
+void ThreadView::AppendPage(const std::vector<ShortSMS>& list) {
+	if (list.empty()) {
+		return;
+	}
+
+	for (const ShortSMS& shortSms : list) {
+		m_bubbles.push_back(MakeBubble(shortSms, State::SENT));
+	}
+
+	UpdatePositions();
+	UpdateScrollBar();
+
+	viewport()->update();
+}
+
+void ThreadView::PrependPage(const std::vector<ShortSMS>& list) {
+	if (list.empty()) {
+		return;
+	}
+
+	QScrollBar* scrollBar = verticalScrollBar();
+
+	/* The messages already shown stay where they are on screen */
+	int before = m_bubbles.empty() ? 0 : (m_bubbles.front().top + ContentOffset());
+
+	auto iterator = list.rbegin();
+
+	while (iterator != list.rend()) {
+		m_bubbles.push_front(MakeBubble(*iterator, State::SENT));
+
+		++iterator;
+	}
+
+	int value = scrollBar->value();
+	int anchor = static_cast<int>(list.size());
+
+	UpdatePositions();
+	UpdateScrollBar();
+
+	if (anchor < Count()) {
+		scrollBar->setValue(value + BubbleTop(anchor) - before);
+	} else {
+		scrollBar->setValue(scrollBar->maximum());
+	}
+
+	viewport()->update();
+}
+
+quint64 ThreadView::Append(const ShortSMS& shortSms, const State& state) {
+	bool atBottom = IsAtBottom();
+
+	m_bubbles.push_back(MakeBubble(shortSms, state));
+
+	UpdatePositions();
+	UpdateScrollBar();
+
+	if (atBottom) {
+		ScrollToBottom();
+	}
+
+	viewport()->update();
+
+	return m_bubbles.back().identifier;
+}
+
+void ThreadView::SetState(quint64 identifier, const State& state) {
+	auto iterator = m_bubbles.rbegin();
+
+	while (iterator != m_bubbles.rend() && iterator->identifier != identifier) {
+		++iterator;
+	}
+
+	if (iterator == m_bubbles.rend() || iterator->state == state) {
+		return;
+	}
+
+	bool atBottom = IsAtBottom();
+
+	iterator->state = state;
+
+	/* The status line changes the bubble size */
+	LayoutBubble(*iterator);
+
+	UpdatePositions();
+	UpdateScrollBar();
+
+	if (atBottom) {
+		ScrollToBottom();
+	}
+
+	viewport()->update();
+}
+
+void ThreadView::RemoveFirst(int count) {
+	count = std::min(count, Count());
+
+	if (count <= 0) {
+		return;
+	}
+
+	QScrollBar* scrollBar = verticalScrollBar();
+
+	int value = scrollBar->value();
+	int before = (count < Count()) ? BubbleTop(count) : 0;
+
+	m_bubbles.erase(m_bubbles.begin(), m_bubbles.begin() + count);
+
+	UpdatePositions();
+	UpdateScrollBar();
+
+	if (!m_bubbles.empty()) {
+		scrollBar->setValue(value + BubbleTop(0) - before);
+	}
+
+	viewport()->update();
+}
+
+void ThreadView::RemoveLast(int count) {
+	count = std::min(count, Count());
+
+	if (count <= 0) {
+		return;
+	}
+
+	m_bubbles.erase(m_bubbles.end() - count, m_bubbles.end());
+
+	UpdatePositions();
+	UpdateScrollBar();
+
+	viewport()->update();
+}
+
+void ThreadView::Clear() {
+	m_bubbles.clear();
+
+	UpdatePositions();
+	UpdateScrollBar();
+
+	viewport()->update();
+}
+
+void ThreadView::ScrollToBottom() {
+	verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void ThreadView::paintEvent(QPaintEvent* e) {
+	const Theme& theme = Theme::Get();
+
+	QPainter painter(viewport());
+
+	bool enabled = isEnabled();
+
+	if (m_bubbles.empty()) {
+		if (!m_placeholder.isEmpty()) {
+			painter.setFont(theme.textFont);
+			painter.setPen(enabled ? theme.titleColor : theme.disabledColor);
+
+			painter.drawText(viewport()->rect(), Qt::AlignCenter, m_placeholder);
+		}
+
+		return;
+	}
+
+	int offset = ContentOffset() - verticalScrollBar()->value();
+	int width = viewport()->width();
+
+	QRect clip = e->rect();
+
+	/* First bubble that can reach into the dirty area */
+	auto iterator = std::upper_bound(m_bubbles.begin(),
+									 m_bubbles.end(),
+									 clip.top() - offset,
+	[](int y, const Bubble & bubble) {
+		return y < bubble.top;
+	});
+
+	if (iterator != m_bubbles.begin()) {
+		--iterator;
+	}
+
+	while (iterator != m_bubbles.end() && iterator->top + offset <= clip.bottom()) {
+		const Bubble& bubble = *iterator;
+
+		QRect rect(QPoint(bubble.incoming ? 0 : (width - bubble.size.width()), bubble.top + offset),
+				   bubble.size);
+
+		if (bubble.incoming) {
+			painter.fillRect(rect, theme.bubbleIncoming);
+		} else if (bubble.state == State::PENDING) {
+			painter.fillRect(rect, theme.bubblePending);
+		} else if (bubble.state == State::FAILED) {
+			painter.fillRect(rect, theme.bubbleFailed);
+		} else {
+			painter.fillRect(rect, theme.bubbleOutgoing);
+		}
+
+		painter.setFont(theme.textFont);
+		painter.setPen(enabled ? (bubble.incoming ? theme.incomingColor : theme.titleColor) : theme.disabledColor);
+
+		painter.drawStaticText(rect.left() + theme.itemMargin, rect.top() + theme.itemMargin, bubble.text);
+
+		if (bubble.state != State::SENT) {
+			int height = theme.smallMetrics.height();
+
+			painter.setFont(theme.smallFont);
+			painter.setPen(enabled ? theme.textColor : theme.disabledColor);
+
+			painter.drawText(QRect(rect.left() + theme.itemMargin,
+								   rect.bottom() - theme.itemMargin - height + 1,
+								   rect.width() - 2 * theme.itemMargin,
+								   height),
+							 Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+							 (bubble.state == State::PENDING) ? "Sending…" : "Failed to send");
+		}
+
+		++iterator;
+	}
+}
+
+void ThreadView::resizeEvent(QResizeEvent* e) {
+	bool atBottom = IsAtBottom();
+
+	QAbstractScrollArea::resizeEvent(e);
+
+	int textWidth = MaxTextWidth();
+
+	if (textWidth != m_textWidth) {
+		m_textWidth = textWidth;
+
+		LayoutAll();
+	}
+
+	UpdateScrollBar();
+
+	if (atBottom) {
+		ScrollToBottom();
+	}
+}
+
+void ThreadView::changeEvent(QEvent* e) {
+	QAbstractScrollArea::changeEvent(e);
+
+	if (e->type() == QEvent::EnabledChange) {
+		viewport()->update();
+	}
+}
+
+void ThreadView::scrollContentsBy(int, int) {
+	viewport()->update();
+}
+
+ThreadView::Bubble ThreadView::MakeBubble(const ShortSMS& shortSms, const State& state) {
+	Bubble bubble;
+
+	bubble.identifier = m_nextIdentifier++;
+	bubble.incoming = shortSms.incoming;
+	bubble.state = state;
+	bubble.body = shortSms.body;
+	bubble.top = 0;
+
+	/* Plain text static text only breaks lines on line separators */
+	QString text = shortSms.body;
+	text.replace('\n', QChar::LineSeparator);
+
+	bubble.text.setText(text);
+	bubble.text.setTextFormat(Qt::PlainText);
+	bubble.text.setPerformanceHint(QStaticText::AggressiveCaching);
+
+	LayoutBubble(bubble);
+
+	return bubble;
+}
+
+void ThreadView::LayoutBubble(Bubble& bubble) const {
+	const Theme& theme = Theme::Get();
+
+	int naturalWidth = theme.textMetrics.boundingRect(QRect(0, 0, QWIDGETSIZE_MAX, QWIDGETSIZE_MAX),
+											Qt::AlignLeft,
+											bubble.body).width();
+
+	bubble.text.setTextWidth((naturalWidth > m_textWidth) ? m_textWidth : -1);
+	bubble.text.prepare(QTransform(), theme.textFont);
+
+	QSizeF textSize = bubble.text.size();
+
+	int width = static_cast<int>(std::ceil(textSize.width()));
+	int height = static_cast<int>(std::ceil(textSize.height()));
+
+	if (bubble.state != State::SENT) {
+		width = std::max(width, theme.smallMetrics.horizontalAdvance((bubble.state == State::PENDING)
+						 ? "Sending…"
+						 : "Failed to send"));
+		height += theme.smallMetrics.height();
+	}
+
+	bubble.size = QSize(width + 2 * theme.itemMargin, height + 2 * theme.itemMargin);
+}
+
+void ThreadView::LayoutAll() {
+	for (Bubble& bubble : m_bubbles) {
+		LayoutBubble(bubble);
+	}
+
+	UpdatePositions();
+}
+
+void ThreadView::UpdatePositions() {
+	int spacing = Theme::Get().itemSpacing;
+	int top = 0;
+
+	for (Bubble& bubble : m_bubbles) {
+		bubble.top = top;
+
+		top += bubble.size.height() + spacing;
+	}
+
+	m_contentHeight = m_bubbles.empty() ? 0 : (top - spacing);
+}
+
+void ThreadView::UpdateScrollBar() {
+	QScrollBar* scrollBar = verticalScrollBar();
+
+	int height = viewport()->height();
+
+	scrollBar->setPageStep(height);
+	scrollBar->setRange(0, std::max(m_contentHeight - height, 0));
+}
+
+int ThreadView::MaxTextWidth() const {
+	/* Not laid out until shown, the final width is not known yet */
+	if (!isVisible()) {
+		return m_textWidth;
+	}
+
+	int available = viewport()->width() - 2 * Theme::Get().itemMargin;
+
+	return std::max(std::min(available, BUBBLE_MAX_TEXT_WIDTH), 1);
+}
+
+int ThreadView::ContentOffset() const {
+	/* Short threads sit at the bottom, next to the input */
+	return std::max(viewport()->height() - m_contentHeight, 0);
+}
+
+bool ThreadView::IsAtBottom() const {
+	return (verticalScrollBar()->value() >= verticalScrollBar()->maximum());
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <QString>
+#include <QStaticText>
+#include <QAbstractScrollArea>
+
+#include "../common.h"
+
+/*
+ * SMS thread painted as a single widget
+ *
+ * Every message keeps its laid out text, which is only laid out again
+ * when the available width changes. Only the bubbles intersecting the
+ * viewport are painted. Scroll positions are kept when messages are
+ * added or dropped at either end.
+ */
+
+class ThreadView : public QAbstractScrollArea {
+		Q_OBJECT
+
+	public:
+		enum class State : uint8_t {
+			SENT = 0,
+			PENDING,
+			FAILED
+		};
+
+		ThreadView(QWidget* parent = nullptr);
+
+		void SetPlaceholder(const QString& text);
+
+		int Count() const;
+		int BubbleTop(int index) const;
+		int BubbleBottom(int index) const;
+
+		void AppendPage(const std::vector<ShortSMS>& list);
+		void PrependPage(const std::vector<ShortSMS>& list);
+		quint64 Append(const ShortSMS& shortSms, const State& state = State::SENT);
+		void SetState(quint64 identifier, const State& state);
+
+		void RemoveFirst(int count);
+		void RemoveLast(int count);
+		void Clear();
+
+		void ScrollToBottom();
+
+	protected:
+		void paintEvent(QPaintEvent* e) override;
+		void resizeEvent(QResizeEvent* e) override;
+		void changeEvent(QEvent* e) override;
+		void scrollContentsBy(int dx, int dy) override;
+
+	private:
+		struct Bubble {
+			quint64 identifier;
+			bool incoming;
+			State state;
+			QString body;
+			QStaticText text;
+			QSize size;
+			int top;
+		};
+
+		std::deque<Bubble> m_bubbles;
+		quint64 m_nextIdentifier;
+
+		QString m_placeholder;
+
+		int m_textWidth;
+		int m_contentHeight;
+
+		Bubble MakeBubble(const ShortSMS& shortSms, const State& state);
+		void LayoutBubble(Bubble& bubble) const;
+		void LayoutAll();
+		void UpdatePositions();
+		void UpdateScrollBar();
+
+		int MaxTextWidth() const;
+		int ContentOffset() const;
+		bool IsAtBottom() const;
+};